@@ -326,9 +326,13 @@ void bigraph_generator(FILE *fp, FILE* octp, int m, int n, float mean, float std
 
   writebits(&bitbuffer, &used, 6 - (used % 6), 0, fp);
 
-  for (o = 0; o < oct; o++) {
-      fprintf(octp, "%d\n", o+m+n);
-  }
+  // the octset as one run of consecutive vertices, in the binary format that
+  // prescribed_octset reads: magic, number of runs, then (first, count) ints
+  long runs = oct > 0 ? 1 : 0;
+  int run[2] = {m + n, oct};
+  fwrite("SRAPXOCT", 1, 8, octp);
+  fwrite(&runs, sizeof(long), 1, octp);
+  fwrite(run, sizeof(int), 2 * runs, octp);
 
   printf("%d\n", e);
 
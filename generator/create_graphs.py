@@ -0,0 +1,45 @@
+import math
+import os
+import sys
+
+from sr_apx.generate import write_oct_graph
+
+# the parameter sweep of create_graphs_vc.sh, generating each graph in
+# process and in parallel instead of running generator.out per graph
+def main():
+    if len(sys.argv) < 3:
+        print("usage: python generator/create_graphs.py <edges> <directory>")
+        sys.exit(1)
+
+    edges = int(sys.argv[1])
+    directory = sys.argv[2]
+    os.makedirs(directory, exist_ok=True)
+
+    # the values are kept as written in the script, which names the files
+    for balance in ["1", "2", "10", "100"]:
+        for octsize in [".01", ".05", ".1", ".25", ".4"]:
+            for bbdens in [".01", ".001", ".005"]:
+                for oodens in [".05", ".001", ".01"]:
+                    for obdens in [".01", ".05"]:
+                        for cv in [".5", "1.5"]:
+                            b = int(balance)
+                            o = float(octsize) * (b + 1) / (1 - float(octsize))
+
+                            bbedges = b * float(bbdens)
+                            obedges = o * (b + 1) * float(obdens)
+                            ooedges = o * o * float(oodens) / 2
+
+                            left = int(math.sqrt(edges / (bbedges + obedges + ooedges)))
+                            right = left * b
+                            oct = int(o * left)
+
+                            mean = left * float(bbdens)
+                            std = mean / 2
+
+                            for seed in range(5):
+                                name = "{}/m{}_bal{}_oo{}_ob{}_bb{}_oct{}_cv{}_copy{}".format(directory, edges, balance, oodens, obdens, bbdens, octsize, cv, seed)
+                                write_oct_graph(name, left, right, mean, std, oct, float(oodens), float(obdens), float(cv), seed)
+                                print(name)
+
+if __name__ == "__main__":
+    main()
@@ -1,18 +1,29 @@
 
 #include <dirent.h>
+#include <cstdlib>
 //#include <fstream>
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
 #include "time.h"
 
 #include "graph.hpp"
+#include "csr.hpp"
+#include "input.hpp"
 #include "bipartite.hpp"
 #include "setmap.hpp"
 
 #include "vc_apx.hpp"
 #include "vc_exact.hpp"
 #include "vc_lift.hpp"
+#include "vc_split.hpp"
+#include "lift_engine.hpp"
+#include "portfolio.hpp"
+#include "vc_recursive.hpp"
+#include "vc_bound.hpp"
+#include "vc_stream.hpp"
+#include "util.hpp"
 
 // helper function declarations ////////////////////////////////////////////////
 
@@ -20,6 +31,7 @@ double sum(double* vals, int len);
 int min(int* vals, int len);
 int max(int* vals, int len);
 void read_directory(const std::string& name, std::vector<std::string>& v);
+void print_ratio(int size, int bound);
 
 // main.py functions ///////////////////////////////////////////////////////////
 
@@ -66,10 +78,49 @@ double run_lift(Set* (*lift)(Graph*, Set*, Set*), Graph* graph, int n, Set* octs
 
 int main(int argc, char* argv[]) {
 	std::string filepath = argv[1];
+
+	// optional flags after the path
+	int exact_k = -1;
+	double exact_time = 60;
+	bool fused = false;
+	double portfolio = 0;
+	int depth = 0;
+	bool stream = false;
+	bool mapped = false;
+	bool planted = false;
+	for (int i = 2; i < argc; i++) {
+		std::string flag = argv[i];
+		if (flag == "--exact-oct" && i + 1 < argc) {
+			exact_k = atoi(argv[++i]);
+		}
+		else if (flag == "--oct-time" && i + 1 < argc) {
+			exact_time = atof(argv[++i]);
+		}
+		else if (flag == "--fused") {
+			fused = true;
+		}
+		else if (flag == "--portfolio" && i + 1 < argc) {
+			portfolio = atof(argv[++i]);
+		}
+		else if (flag == "--depth" && i + 1 < argc) {
+			depth = atoi(argv[++i]);
+		}
+		else if (flag == "--stream") {
+			stream = true;
+		}
+		else if (flag == "--mmap") {
+			mapped = true;
+		}
+		else if (flag == "--planted") {
+			planted = true;
+		}
+	}
+
+	// graphs may be compressed as .s6.gz or .s6.zst
 	bool directory = true;
 	if (filepath[filepath.size()-1] != '/') {
-		if (filepath[filepath.size()-3] == '.' && filepath[filepath.size()-2] == 's'
-		    && filepath[filepath.size()-1] == '6')
+		std::string name = uncompressed_name(filepath.c_str());
+		if (name.size() > 3 && name.compare(name.size()-3, 3, ".s6") == 0)
 			directory = false;
 		else
 			filepath += "/";
@@ -93,17 +144,95 @@ int main(int argc, char* argv[]) {
     for (std::vector<std::string>::iterator graph_files_it = graph_files.begin();
 		graph_files_it != graph_files.end(); graph_files_it++) {
 		std::string filename = *graph_files_it;
-		if (filename.find(".s6") == std::string::npos)
+		std::string name = uncompressed_name(filename.c_str());
+		if (name.find(".s6") == std::string::npos)
+			continue;
+		name = name.substr(0, name.length()-3);
+
+		printf("%s\n", name.c_str());
+
+		if (stream) {
+			double start_time = wall_time();
+			StreamCover result = stream_cover((filepath + filename).c_str());
+			if (result.cover == NULL) {
+				printf("could not read %s\n\n", filename.c_str());
+				continue;
+			}
+
+			printf("n: %d\n", result.n);
+			printf("m: %ld\n", result.m);
+			printf("stream cover\n");
+			printf("\ttime: %.4f\n", wall_time() - start_time);
+			printf("\tpasses: %d\n", result.passes);
+			printf("\tmatching size: %d\n", 2 * result.matching);
+			printf("\toct size: %d\n", result.octset->size());
+			printf("\tsize: %d\n", result.cover->size());
+			delete result.octset;
+			delete result.cover;
+			printf("\n");
 			continue;
+		}
 
-		printf("%s\n", (filename.substr(0, filename.length()-3)).c_str());
+		if (mapped) {
+			// the csr file is written next to the graph once and reused until
+			// the graph file changes
+			std::string csrfile = filepath + name + ".csr";
+			std::string source = filepath + filename;
+			double start_time = wall_time();
+			CSRGraph* csr = map_csr(csrfile.c_str(), source.c_str());
+			if (csr == NULL && write_csr(source.c_str(), csrfile.c_str())) {
+				csr = map_csr(csrfile.c_str());
+			}
+			if (csr == NULL) {
+				printf("could not map %s\n\n", csrfile.c_str());
+				continue;
+			}
+
+			printf("n: %d\n", csr->n);
+			printf("csr time: %.4f\n", wall_time() - start_time);
+
+			start_time = wall_time();
+			csr->advise(false);
+			Set* oct = vertex_delete(csr);
+			Set* partial = bip_exact(csr, oct);
+			printf("bip solve\n");
+			printf("\ttime: %.4f\n", wall_time() - start_time);
+			printf("\toct size: %d\n", oct->size());
+			printf("\tsize: %d\n", partial->size());
+
+			int k = depth > 0 ? depth : 2;
+			start_time = wall_time();
+			Set* cover = recursive_k_lift(csr, oct, partial, k);
+			printf("recursive %d lift\n", k);
+			printf("\ttime: %.4f\n", wall_time() - start_time);
+			printf("\tsize: %d\n", cover->size());
+
+			delete cover;
+			delete partial;
+			delete oct;
+			delete csr;
+			printf("\n");
+			continue;
+		}
 
 		clock_t start = clock();
 		Graph* graph = read_sparse6((filepath + filename).c_str());
 		clock_t end = clock();
+		if (graph == NULL) {
+			printf("could not read %s\n\n", (filepath + filename).c_str());
+			continue;
+		}
 		printf("n: %d\n", graph->size());
 		printf("time: %.4f\n", (double)(end-start)/1000000);
 
+		LowerBounds lb = lower_bounds(graph);
+		printf("lower bound\n");
+		printf("\ttime: %.4f\n", lb.time);
+		printf("\tmatching: %d\n", lb.matching);
+		printf("\tlp: %d\n", lb.lp);
+		printf("\tpacking: %d\n", lb.packing);
+		printf("\tbest: %d\n", lb.best);
+
 		int minsol;
 		int maxsol;
 		double t;
@@ -112,23 +241,64 @@ int main(int argc, char* argv[]) {
 		printf("heuristic apx\n");
 		printf("\tavg time: %.4f\n", t/1000000);
 		printf("\tmin size: %d\n", minsol);
+		print_ratio(minsol, lb.best);
 		printf("\tmax size: %d\n", maxsol);
 
 		t = run_apx(dfs_apx, graph, n, minsol, maxsol);
 		printf("dfs apx\n");
 		printf("\tavg time: %.4f\n", t/1000000);
 		printf("\tmin size: %d\n", minsol);
+		print_ratio(minsol, lb.best);
 		printf("\tmax size: %d\n", maxsol);
 
 		t = run_apx(std_apx, graph, n, minsol, maxsol);
 		printf("std apx\n");
 		printf("\tavg time: %.4f\n", t/1000000);
 		printf("\tmin size: %d\n", minsol);
+		print_ratio(minsol, lb.best);
+
+		t = run_apx(split_heuristic_apx, graph, n, minsol, maxsol);
+		printf("split heuristic apx\n");
+		printf("\tavg time: %.4f\n", t/1000000);
+		printf("\tmin size: %d\n", minsol);
+		print_ratio(minsol, lb.best);
+		printf("\tmax size: %d\n", maxsol);
+
+		t = run_apx(split_std_apx, graph, n, minsol, maxsol);
+		printf("split std apx\n");
+		printf("\tavg time: %.4f\n", t/1000000);
+		printf("\tmin size: %d\n", minsol);
+		print_ratio(minsol, lb.best);
+		printf("\tmax size: %d\n", maxsol);
 
 		start = clock();
-		Set* oct = vertex_delete(graph);
+		Set* oct = NULL;
+		if (planted) {
+			// the octset planted by the generator, next to the graph
+			oct = prescribed_octset(graph, (filepath + name + ".oct").c_str());
+			if (oct == NULL) {
+				printf("no planted octset, computing one\n");
+			}
+			else {
+				printf("planted oct size: %d\n", oct->size());
+			}
+		}
+		if (oct == NULL && exact_k >= 0) {
+			bool optimal;
+			oct = exact_octset(graph, exact_k, exact_time, &optimal);
+			printf("oct size: %d%s\n", oct->size(), optimal ? " (optimal)" : "");
+		}
+		else if (oct == NULL) {
+			oct = vertex_delete(graph);
+		}
 		Set** od = verify_bipartite(graph, oct);
 
+		// a planted octset from a file that does not match the graph may
+		// leave odd cycles, whose vertices verify_bipartite puts in od[0]
+		for (Set::Iterator it = od[0]->begin(); it != od[0]->end(); ++it) {
+			oct->insert(*it);
+		}
+
 		Set* bippart = new Set();
 		for (Set::Iterator left_it = od[1]->begin(); left_it != od[1]->end(); left_it++) {
 			int left = *left_it;
@@ -139,10 +309,16 @@ int main(int argc, char* argv[]) {
 			bippart->insert(right);
 		}
 
-		Set* partial = bip_exact(graph->subgraph(bippart));
+		// the coloring from verify_bipartite is reused instead of recomputed
+		Graph* bipgraph = graph->subgraph(bippart);
+		Set* partial = bip_exact(bipgraph, od[1]);
 		end = clock();
 
+		delete bipgraph;
 		delete bippart;
+		delete od[0];
+		delete od[1];
+		delete od[2];
 		delete[] od;
 
 		printf("bip solve\n");
@@ -150,54 +326,108 @@ int main(int argc, char* argv[]) {
 
 		printf("%d\n", partial->size());
 
-		t = run_lift(naive_lift, graph, n, oct, partial, minsol, maxsol);
-		printf("naive lift\n");
-		printf("\tavg time: %.4f\n", t/1000000);
-		printf("\tmin size: %d\n", minsol);
-		printf("\tmax size: %d\n", maxsol);
-
-		t = run_lift(greedy_lift, graph, n, oct, partial, minsol, maxsol);
-		printf("greedy lift\n");
-		printf("\tavg time: %.4f\n", t/1000000);
-		printf("\tmin size: %d\n", minsol);
-		printf("\tmax size: %d\n", maxsol);
-
-		t = run_lift(apx_lift, graph, n, oct, partial, minsol, maxsol);
-		printf("apx lift\n");
-		printf("\tavg time: %.4f\n", t/1000000);
-		printf("\tmin size: %d\n", minsol);
-		printf("\tmax size: %d\n", maxsol);
-
-		t = run_lift(oct_lift, graph, n, oct, partial, minsol, maxsol);
-		printf("oct lift\n");
-		printf("\tavg time: %.4f\n", t/1000000);
-		printf("\tmin size: %d\n", minsol);
-		printf("\tmax size: %d\n", maxsol);
-
-		t = run_lift(bip_lift, graph, n, oct, partial, minsol, maxsol);
-		printf("bip lift\n");
-		printf("\tavg time: %.4f\n", t/1000000);
-		printf("\tmin size: %d\n", minsol);
-		printf("\tmax size: %d\n", maxsol);
-
-		t = run_lift(recursive_lift, graph, n, oct, partial, minsol, maxsol);
-		printf("recursive lift\n");
-		printf("\tavg time: %.4f\n", t/1000000);
-		printf("\tmin size: %d\n", minsol);
-		printf("\tmax size: %d\n", maxsol);
-
-		t = run_lift(recursive_oct_lift, graph, n, oct, partial, minsol, maxsol);
-		printf("recursive oct lift\n");
-		printf("\tavg time: %.4f\n", t/1000000);
-		printf("\tmin size: %d\n", minsol);
-		printf("\tmax size: %d\n", maxsol);
-
-		t = run_lift(recursive_bip_lift, graph, n, oct, partial, minsol, maxsol);
-		printf("recursive bip lift\n");
-		printf("\tavg time: %.4f\n", t/1000000);
-		printf("\tmin size: %d\n", minsol);
-		printf("\tmax size: %d\n", maxsol);
+		if (portfolio > 0) {
+			PortfolioResult result = portfolio_lift(graph, oct, partial, portfolio, lb.best);
+			printf("portfolio lift\n");
+			if (result.cover != NULL) {
+				printf("\tbest: %s%s\n", result.strategy.c_str(), result.bound_met ? " (meets lower bound)" : "");
+				printf("\ttime: %.4f\n", result.time);
+				printf("\tsize: %d\n", result.cover->size());
+				print_ratio(result.cover->size(), lb.best);
+				delete result.cover;
+			}
+			else {
+				printf("\tno cover within the deadline\n");
+			}
+		}
+		else if (fused) {
+			LiftEngine engine(graph, oct, partial);
+			for (int l = 0; l < NUM_LIFTS; l++) {
+				LiftResult result = engine.run(lift_names[l]);
+				std::string label = result.name;
+				std::replace(label.begin(), label.end(), '_', ' ');
+				printf("%s lift\n", label.c_str());
+				printf("\ttime: %.4f\n", result.time);
+				printf("\tsize: %d\n", result.cover->size());
+				print_ratio(result.cover->size(), lb.best);
+				delete result.cover;
+			}
+		}
+		else {
+			t = run_lift(naive_lift, graph, n, oct, partial, minsol, maxsol);
+			printf("naive lift\n");
+			printf("\tavg time: %.4f\n", t/1000000);
+			printf("\tmin size: %d\n", minsol);
+			print_ratio(minsol, lb.best);
+			printf("\tmax size: %d\n", maxsol);
+
+			t = run_lift(greedy_lift, graph, n, oct, partial, minsol, maxsol);
+			printf("greedy lift\n");
+			printf("\tavg time: %.4f\n", t/1000000);
+			printf("\tmin size: %d\n", minsol);
+			print_ratio(minsol, lb.best);
+			printf("\tmax size: %d\n", maxsol);
+
+			t = run_lift(apx_lift, graph, n, oct, partial, minsol, maxsol);
+			printf("apx lift\n");
+			printf("\tavg time: %.4f\n", t/1000000);
+			printf("\tmin size: %d\n", minsol);
+			print_ratio(minsol, lb.best);
+			printf("\tmax size: %d\n", maxsol);
+
+			t = run_lift(oct_lift, graph, n, oct, partial, minsol, maxsol);
+			printf("oct lift\n");
+			printf("\tavg time: %.4f\n", t/1000000);
+			printf("\tmin size: %d\n", minsol);
+			print_ratio(minsol, lb.best);
+			printf("\tmax size: %d\n", maxsol);
+
+			t = run_lift(bip_lift, graph, n, oct, partial, minsol, maxsol);
+			printf("bip lift\n");
+			printf("\tavg time: %.4f\n", t/1000000);
+			printf("\tmin size: %d\n", minsol);
+			print_ratio(minsol, lb.best);
+			printf("\tmax size: %d\n", maxsol);
+
+			t = run_lift(recursive_lift, graph, n, oct, partial, minsol, maxsol);
+			printf("recursive lift\n");
+			printf("\tavg time: %.4f\n", t/1000000);
+			printf("\tmin size: %d\n", minsol);
+			print_ratio(minsol, lb.best);
+			printf("\tmax size: %d\n", maxsol);
+
+			t = run_lift(recursive_oct_lift, graph, n, oct, partial, minsol, maxsol);
+			printf("recursive oct lift\n");
+			printf("\tavg time: %.4f\n", t/1000000);
+			printf("\tmin size: %d\n", minsol);
+			print_ratio(minsol, lb.best);
+			printf("\tmax size: %d\n", maxsol);
+
+			t = run_lift(recursive_bip_lift, graph, n, oct, partial, minsol, maxsol);
+			printf("recursive bip lift\n");
+			printf("\tavg time: %.4f\n", t/1000000);
+			printf("\tmin size: %d\n", minsol);
+			print_ratio(minsol, lb.best);
+			printf("\tmax size: %d\n", maxsol);
+		}
 
+		if (depth > 0) {
+			double start_time = wall_time();
+			Set* cover = recursive_k_lift(graph, oct, partial, depth);
+			printf("recursive %d lift\n", depth);
+			printf("\ttime: %.4f\n", wall_time() - start_time);
+			printf("\tsize: %d\n", cover->size());
+			print_ratio(cover->size(), lb.best);
+			delete cover;
+
+			start_time = wall_time();
+			cover = recursive_oct_k_lift(graph, oct, partial, depth);
+			printf("recursive oct %d lift\n", depth);
+			printf("\ttime: %.4f\n", wall_time() - start_time);
+			printf("\tsize: %d\n", cover->size());
+			print_ratio(cover->size(), lb.best);
+			delete cover;
+		}
 
 		delete oct;
 		delete partial;
@@ -236,6 +466,13 @@ int max(int* vals, int len) {
 	return max;
 }
 
+// certified ratio of a cover size to the lower bound
+void print_ratio(int size, int bound) {
+	if (bound > 0) {
+		printf("\tratio: %.4f\n", (double) size / bound);
+	}
+}
+
 // borrowed helper functions ///////////////////////////////////////////////////
 
 /* http://www.martinbroadhurst.com/list-the-files-in-a-directory-in-c.html */
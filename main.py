@@ -13,6 +13,7 @@ from sr_apx.bipartite import prescribed_octset, vertex_delete, verify_bipartite
 from sr_apx.vc.apx import dfs_apx, std_apx, heuristic_apx
 from sr_apx.vc.exact import bip_exact
 from sr_apx.vc.lift import naive_lift, greedy_lift, apx_lift, oct_lift, bip_lift, recursive_lift, recursive_oct_lift, recursive_bip_lift
+from sr_apx.vc.bound import lower_bounds
 
 def run_apx(apx, graph, n):
     times = []
@@ -58,6 +59,9 @@ def main():
         filepath += "/";
     n = 1
 
+    # --planted uses the octset the generator wrote next to each graph
+    planted = "--planted" in sys.argv[2:]
+
     results_dir = os.path.join(os.getcwd(),"results")
     if not os.path.exists(results_dir):
         os.mkdir(results_dir)
@@ -66,18 +70,18 @@ def main():
 
     graph_list = []
     for filename in os.listdir(filepath):
-        if not filename.endswith(".s6"):
+        if not filename.endswith((".s6", ".s6.gz", ".s6.zst")):
             continue
 
         graph_list.append(filename)
 
     with open("results/results.csv", "w") as f:
-        header = ["name","n","m","dfs time","dfs size","heuristic time","heuristic size","std time","std size","stdrev time","stdrev size","oct size","partial","bip time","naive time","naive size","apx time","apx size","greedy time","greedy size","octfirst time","octfirst size","bipfirst time","bipfirst size","rec time","rec size","recoct time","recoct size","recbip time","recbip size"]
+        header = ["name","n","m","dfs time","dfs size","heuristic time","heuristic size","std time","std size","stdrev time","stdrev size","oct size","partial","bip time","naive time","naive size","apx time","apx size","greedy time","greedy size","octfirst time","octfirst size","bipfirst time","bipfirst size","rec time","rec size","recoct time","recoct size","recbip time","recbip size","lower bound","bound time","ratio"]
         results = DictWriter(f, header)
         results.writeheader()
 
         completed = 0
-        total = len(graph_list) * 13
+        total = len(graph_list) * 14
         for filename in graph_list:
             res = {}
 
@@ -89,6 +93,12 @@ def main():
             completed += 1
             update_progress(completed, total)
 
+            bounds = lower_bounds(graph)
+            res["lower bound"] = bounds["best"]
+            res["bound time"] = round(bounds["time"], 4)
+            completed += 1
+            update_progress(completed, total)
+
             t, minsol, maxsol = run_apx(heuristic_apx, graph, n)
             res["heuristic time"] = t
             res["heuristic size"] = minsol
@@ -107,11 +117,18 @@ def main():
             completed += 1
             update_progress(completed, total)
 
-            # left, right, octset = prescibed_octset(graph, "{}{}.oct".format(filepath, graphname))
-
             start = time()
-            octset = vertex_delete(graph)
-            _, left, right = verify_bipartite(graph, octset)
+            octset = None
+            if planted:
+                try:
+                    octset = prescribed_octset(graph, "{}{}.oct".format(filepath, graphname))
+                except OSError:
+                    pass
+            if octset is None:
+                octset = vertex_delete(graph)
+            extra, left, right = verify_bipartite(graph, octset)
+            for v in extra:
+                octset.add(v)
 
             bippart = Set()
             for v in left:
@@ -177,6 +194,11 @@ def main():
             completed += 1
             update_progress(completed, total)
 
+            # certified ratio of the smallest cover found
+            if bounds["best"] > 0:
+                best = min(v for k, v in res.items() if k.endswith(" size") and k != "oct size")
+                res["ratio"] = round(best / bounds["best"], 4)
+
             results.writerow(res)
             del graph
 
@@ -1,2 +1,2 @@
 
-from .lib_bipartite import vertex_delete, verify_bipartite, prescribed_octset
+from .lib_bipartite import vertex_delete, vertex_delete_multistart, exact_octset, verify_bipartite, prescribed_octset, write_octset
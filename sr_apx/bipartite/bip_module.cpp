@@ -4,6 +4,7 @@
 #include "bipartite.hpp"
 #include "pyset.hpp"
 #include "pygraph.hpp"
+#include "pycall.hpp"
 
 static PyObject* bipartite_verifybip(PyObject* self, PyObject* args) {
 	PyObject* g;
@@ -12,10 +13,15 @@ static PyObject* bipartite_verifybip(PyObject* self, PyObject* args) {
 		return NULL;
 	}
 
-	Graph* graph = ((PyGraph*) g)->g;
 	Set* os = ((PySet*) s)->s;
 
-	Set** od = verify_bipartite(graph, os);
+	CSRGraph* csr = get_csr(g);
+	Graph* graph = csr == NULL ? get_graph(g) : NULL;
+	Set** od;
+	{
+		WithoutGIL nogil({g, s});
+		od = csr != NULL ? verify_bipartite(csr, os) : verify_bipartite(graph, os);
+	}
 	PyObject* l = make_PySet(od[1], false);
 	PyObject* r = make_PySet(od[2], false);
 	PyObject* o = make_PySet(od[0], false);
@@ -33,32 +39,109 @@ static PyObject* bipartite_prescribed(PyObject* self, PyObject* args) {
 	char* s;
 	Py_ssize_t len;
 	PyBytes_AsStringAndSize(bytes, &s, &len);
-	Py_DECREF(bytes);
 
-	Graph* graph = ((PyGraph*) g)->g;
+	Graph* graph = get_graph(g);
 
-	Set* oct = prescribed_octset(graph, s);
+	Set* oct;
+	{
+		WithoutGIL nogil({g});
+		oct = prescribed_octset(graph, s);
+	}
+	if (oct == NULL) {
+		PyErr_Format(PyExc_OSError, "could not read an octset from '%s'", s);
+		Py_DECREF(bytes);
+		return NULL;
+	}
+	Py_DECREF(bytes);
 	PyObject* o = make_PySet(oct, false);
 	return o;
 }
 
+static PyObject* bipartite_writeoctset(PyObject* self, PyObject* args) {
+	PyObject* s;
+	PyObject* bytes;
+	if (!PyArg_ParseTuple(args, "OO&", &s, PyUnicode_FSConverter, &bytes)) {
+		return NULL;
+	}
+
+	const char* filename = PyBytes_AS_STRING(bytes);
+	bool written;
+	{
+		WithoutGIL nogil({s});
+		written = write_octset(((PySet*) s)->s, filename);
+	}
+	if (!written) {
+		PyErr_Format(PyExc_OSError, "could not write '%s'", filename);
+	}
+	Py_DECREF(bytes);
+	if (!written) {
+		return NULL;
+	}
+	Py_RETURN_NONE;
+}
+
 static PyObject* bipartite_vertexdelete(PyObject* self, PyObject* args) {
 	PyObject* g;
 	if (!PyArg_ParseTuple(args, "O", &g)) {
 		return NULL;
 	}
 
-	PyGraph* graph = (PyGraph*) g;
+	CSRGraph* csr = get_csr(g);
+	Graph* graph = csr == NULL ? get_graph(g) : NULL;
+	Set* oct;
+	{
+		WithoutGIL nogil({g});
+		oct = csr != NULL ? vertex_delete(csr) : vertex_delete(graph);
+	}
+	PyObject* o = make_PySet(oct, false);
+	return o;
+}
 
-	Set* oct = vertex_delete(graph->g);
+static PyObject* bipartite_multistart(PyObject* self, PyObject* args) {
+	PyObject* g;
+	int starts = 8;
+	double seconds = 0;
+	int threads = 0;
+	if (!PyArg_ParseTuple(args, "O|idi", &g, &starts, &seconds, &threads)) {
+		return NULL;
+	}
+
+	Graph* graph = get_graph(g);
+	Set* oct;
+	{
+		WithoutGIL nogil({g});
+		oct = vertex_delete_multistart(graph, starts, seconds, threads);
+	}
 	PyObject* o = make_PySet(oct, false);
 	return o;
 }
 
+static PyObject* bipartite_exact(PyObject* self, PyObject* args) {
+	PyObject* g;
+	int k;
+	double seconds = 0;
+	if (!PyArg_ParseTuple(args, "Oi|d", &g, &k, &seconds)) {
+		return NULL;
+	}
+
+	Graph* graph = get_graph(g);
+	bool optimal;
+	Set* oct;
+	{
+		WithoutGIL nogil({g});
+		oct = exact_octset(graph, k, seconds, &optimal);
+	}
+	PyObject* o = make_PySet(oct, false);
+	return Py_BuildValue("NO", o, optimal ? Py_True : Py_False);
+}
+
 static PyMethodDef bipartite_methods[] = {
 	{"verify_bipartite", bipartite_verifybip, METH_VARARGS, "computes an oct decomposition from a given octset"},
-	{"prescribed_octset", bipartite_prescribed, METH_VARARGS, "reads a predetermined octset from a file"},
+	{"prescribed_octset", bipartite_prescribed, METH_VARARGS, "reads a predetermined octset from a text or binary octset file, keeping the vertices in the graph"},
+	{"write_octset", bipartite_writeoctset, METH_VARARGS, "writes an octset to a binary file of runs of consecutive vertices"},
 	{"vertex_delete", bipartite_vertexdelete, METH_VARARGS, "computes an octset for a given graph"},
+	{"exact_octset", bipartite_exact, METH_VARARGS, "computes a minimum octset of size at most k by iterative compression, falling back to vertex_delete"},
+	{"vertex_delete_multistart", bipartite_multistart, METH_VARARGS, "computes the smallest octset over several randomized runs within a time budget"},
 	{NULL},
 };
 
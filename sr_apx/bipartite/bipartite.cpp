@@ -1,158 +1,570 @@
 
 #include "bipartite.hpp"
+#include "cancel.hpp"
+#include "csr.hpp"
+#include "parallel.hpp"
+#include "util.hpp"
 
-// consider vector here
-#include <deque>
+#include <algorithm>
+#include <climits>
+#include <cstring>
 #include <iostream>
 #include <fstream>
+#include <mutex>
+#include <random>
+#include <vector>
 
+// an octset file is either text with one vertex per line, or binary: a
+// header and then runs of consecutive vertices as (first, count) ints
+#define OCT_MAGIC "SRAPXOCT"
+
+struct OctHeader {
+	char magic[8];
+	long runs;
+};
+
+// keeps only the vertices of the graph, a planted vertex that got no edges
+// is not in it
 Set* prescribed_octset(Graph* graph, const char* filename) {
 	std::ifstream f;
-	f.open(filename, std::ios::in);
+	f.open(filename, std::ios::in | std::ios::binary | std::ios::ate);
+	if (!f.is_open()) {
+		return NULL;
+	}
+
+	std::vector<char> data(f.tellg());
+	f.seekg(0);
+	f.read(data.data(), data.size());
+	f.close();
 
 	Set* octset = new Set();
+	OctHeader header;
+	if (data.size() >= sizeof(OctHeader) && memcmp(data.data(), OCT_MAGIC, 8) == 0) {
+		memcpy(&header, data.data(), sizeof(OctHeader));
+		// runs is bounded by the file before it is multiplied
+		size_t space = (data.size() - sizeof(OctHeader)) / (2 * sizeof(int));
+		if (header.runs < 0 || (size_t) header.runs > space || data.size() != sizeof(OctHeader) + header.runs * 2 * sizeof(int)) {
+			delete octset;
+			return NULL;
+		}
+
+		std::vector<int> runs(2 * header.runs);
+		memcpy(runs.data(), data.data() + sizeof(OctHeader), runs.size() * sizeof(int));
+		long total = 0;
+		for (long r = 0; r < header.runs; r++) {
+			total += std::max(runs[2 * r + 1], 0);
+		}
+		octset->reserve(std::min(total, (long) graph->size()));
 
-	char s[100];
-	while (f.getline(s, 100)) {
-		int u;
-		sscanf(s, "%d", &u);
-		octset->insert(u);
+		// the end of a run is computed in long so that it cannot overflow
+		for (long r = 0; r < header.runs; r++) {
+			long end = std::min((long) runs[2 * r] + runs[2 * r + 1], (long) INT_MAX + 1);
+			for (long u = runs[2 * r]; u < end; u++) {
+				if (graph->adjlist.contains(u)) {
+					octset->insert(u);
+				}
+			}
+		}
+		return octset;
 	}
 
-	f.close();
+	// a '-' right before the digits keeps the number negative, as sscanf did.
+	// numbers outside the int range cannot be vertices and are skipped
+	const char* p = data.data();
+	const char* end = p + data.size();
+	while (p < end) {
+		if (*p < '0' || *p > '9') {
+			++p;
+			continue;
+		}
+
+		bool negative = p > data.data() && p[-1] == '-';
+		long u = 0;
+		while (p < end && *p >= '0' && *p <= '9') {
+			if (u <= INT_MAX) {
+				u = 10 * u + (*p - '0');
+			}
+			++p;
+		}
+		u = negative ? -u : u;
+		if (u >= INT_MIN && u <= INT_MAX && graph->adjlist.contains(u)) {
+			octset->insert(u);
+		}
+	}
 	return octset;
 }
 
+bool write_octset(Set* octset, const char* filename) {
+	std::vector<int> vertices;
+	vertices.reserve(octset->size());
+	for (Set::Iterator it = octset->begin(); it != octset->end(); ++it) {
+		vertices.push_back(*it);
+	}
+	std::sort(vertices.begin(), vertices.end());
+
+	std::vector<int> runs;
+	for (auto it = vertices.begin(); it != vertices.end(); ++it) {
+		if (!runs.empty() && runs[runs.size() - 2] + runs.back() == *it) {
+			++runs.back();
+		}
+		else {
+			runs.push_back(*it);
+			runs.push_back(1);
+		}
+	}
+
+	OctHeader header;
+	memcpy(header.magic, OCT_MAGIC, 8);
+	header.runs = runs.size() / 2;
+
+	std::ofstream f;
+	f.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!f.is_open()) {
+		return false;
+	}
+	f.write((const char*) &header, sizeof(OctHeader));
+	f.write((const char*) runs.data(), runs.size() * sizeof(int));
+	f.close();
+	return !f.fail();
+}
+
 Set** verify_bipartite(Graph* graph, Set* os) {
+	CSRGraph csr(graph);
+	return verify_bipartite(&csr, os);
+}
+
+Set** verify_bipartite(CSRGraph* csr, Set* os) {
+	int n = csr->n;
+
+	signed char* color = new signed char[n];
+	for (int i = 0; i < n; i++) {
+		color[i] = os->contains(csr->labels[i]) ? COLOR_EXCLUDED : COLOR_NONE;
+	}
+
+	color_bipartite(csr, color);
+
+	Set* octset = new Set();
 	Set* left = new Set();
 	Set* right = new Set();
-	Set* octset = new Set();
+	for (int i = 0; i < n; i++) {
+		if (color[i] == COLOR_LEFT) {
+			left->insert(csr->labels[i]);
+		}
+		else if (color[i] == COLOR_RIGHT) {
+			right->insert(csr->labels[i]);
+		}
+		else if (color[i] == COLOR_OCT) {
+			octset->insert(csr->labels[i]);
+		}
+	}
+
+	delete[] color;
+
+	Set** ret = new Set*[3];
+	ret[0] = octset;
+	ret[1] = left;
+	ret[2] = right;
+	return ret;
+}
 
-	Set visited;
-	for (Set::Iterator it = os->begin(); it != os->end(); ++it) {
-		visited.insert(*it);
+// frontiers at least this large are expanded by several threads
+#define PARALLEL_FRONTIER 4096
+// switch to bottom-up expansion once the frontier holds 1/BOTTOM_UP of the vertices
+#define BOTTOM_UP 16
+
+// expands one bfs level, coloring the next level and returning it
+std::vector<int> expand_frontier(CSRGraph* graph, signed char* color, char* infrontier,
+								 std::vector<int>& frontier, int threads) {
+	int n = graph->n;
+	std::vector<int> next;
+
+	if ((int) frontier.size() < PARALLEL_FRONTIER || threads <= 1) {
+		for (auto it = frontier.begin(); it != frontier.end(); ++it) {
+			int u = *it;
+			for (int* iv = graph->begin(u); iv != graph->end(u); ++iv) {
+				if (color[*iv] == COLOR_NONE) {
+					color[*iv] = 1 - color[u];
+					next.push_back(*iv);
+				}
+			}
+		}
+		return next;
 	}
 
-	auto git = graph->begin();
+	std::vector<std::vector<int>> local(threads);
 
-	std::deque<int> queue;
-	int current;
+	if ((long) frontier.size() * BOTTOM_UP >= n) {
+		// bottom-up: every uncolored vertex looks for a parent in the frontier
+		for (auto it = frontier.begin(); it != frontier.end(); ++it) {
+			infrontier[*it] = 1;
+		}
 
-	while (visited.size() < graph->size() || !queue.empty()) {
-		if (queue.empty()) {
-			while (visited.contains(*git)) {
-				++git;
+		int chunk = (n + threads - 1) / threads;
+		parallel_for(threads, [&](int t) {
+			int last = (t + 1) * chunk < n ? (t + 1) * chunk : n;
+			for (int w = t * chunk; w < last; w++) {
+				if (color[w] != COLOR_NONE) {
+					continue;
+				}
+
+				for (int* iv = graph->begin(w); iv != graph->end(w); ++iv) {
+					if (infrontier[*iv]) {
+						color[w] = 1 - color[*iv];
+						local[t].push_back(w);
+						break;
+					}
+				}
 			}
+		}, threads);
 
-			current = *git;
-			left->insert(current);
-			visited.insert(current);
+		for (auto it = frontier.begin(); it != frontier.end(); ++it) {
+			infrontier[*it] = 0;
 		}
-		else {
-			current = queue.front();
-			queue.pop_front();
+	}
+	else {
+		// top-down: frontier vertices claim their uncolored neighbors
+		int size = frontier.size();
+		int chunk = (size + threads - 1) / threads;
+		parallel_for(threads, [&](int t) {
+			int last = (t + 1) * chunk < size ? (t + 1) * chunk : size;
+			for (int i = t * chunk; i < last; i++) {
+				int u = frontier[i];
+				signed char c = 1 - color[u];
+				for (int* iv = graph->begin(u); iv != graph->end(u); ++iv) {
+					signed char expected = COLOR_NONE;
+					if (__atomic_load_n(&color[*iv], __ATOMIC_RELAXED) == COLOR_NONE &&
+						__atomic_compare_exchange_n(&color[*iv], &expected, c, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+						local[t].push_back(*iv);
+					}
+				}
+			}
+		}, threads);
+	}
+
+	for (int t = 0; t < threads; t++) {
+		next.insert(next.end(), local[t].begin(), local[t].end());
+	}
+	return next;
+}
+
+// 2-colors the vertices not marked COLOR_EXCLUDED by breadth first search.
+// color takes the level parity, so endpoints of an edge with equal colors lie
+// on an odd cycle; for each such edge the larger endpoint is marked COLOR_OCT.
+// returns the number of vertices marked COLOR_OCT
+int color_bipartite(CSRGraph* graph, signed char* color, int threads) {
+	int n = graph->n;
+	if (threads <= 0) {
+		threads = num_threads();
+	}
+
+	char* infrontier = new char[n];
+	for (int i = 0; i < n; i++) {
+		infrontier[i] = 0;
+	}
+
+	for (int s = 0; s < n; s++) {
+		if (color[s] != COLOR_NONE) {
+			continue;
 		}
 
-		Set* nbrs = graph->neighbors(current);
-		for (Set::Iterator it = nbrs->begin(); it != nbrs->end(); ++it) {
-			int nbr = *it;
-			if (os->contains(nbr) || octset->contains(nbr)) {
+		color[s] = COLOR_LEFT;
+		std::vector<int> frontier(1, s);
+		while (!frontier.empty()) {
+			frontier = expand_frontier(graph, color, infrontier, frontier, threads);
+		}
+	}
+
+	delete[] infrontier;
+
+	std::vector<std::vector<int>> conflicts(threads);
+	int chunk = (n + threads - 1) / threads;
+	parallel_for(threads, [&](int t) {
+		int last = (t + 1) * chunk < n ? (t + 1) * chunk : n;
+		for (int u = t * chunk; u < last; u++) {
+			if (color[u] != COLOR_LEFT && color[u] != COLOR_RIGHT) {
 				continue;
 			}
 
-			if (left->contains(current)) {
-				right->insert(nbr);
-			}
-			else {
-				left->insert(nbr);
+			for (int* iv = graph->begin(u); iv != graph->end(u); ++iv) {
+				if (*iv < u && color[*iv] == color[u]) {
+					conflicts[t].push_back(u);
+					conflicts[t].push_back(*iv);
+				}
 			}
+		}
+	}, threads);
 
-			if (left->contains(nbr) && right->contains(nbr)) {
-				left->erase(nbr);
-				right->erase(nbr);
-				octset->insert(nbr);
-				continue;
+	// chunks are in vertex order, so this pass is independent of the thread count
+	int count = 0;
+	for (int t = 0; t < threads; t++) {
+		for (size_t i = 0; i < conflicts[t].size(); i += 2) {
+			int u = conflicts[t][i];
+			int v = conflicts[t][i + 1];
+			if (color[u] != COLOR_OCT && color[v] != COLOR_OCT) {
+				color[u] = COLOR_OCT;
+				++count;
 			}
+		}
+	}
 
-			if (!visited.contains(nbr)) {
-				visited.insert(nbr);
-				queue.push_back(nbr);
-			}
+	return count;
+}
+
+// collects the vertices colored COLOR_OCT, COLOR_LEFT and COLOR_RIGHT into
+// three arrays, storing their lengths in sizes
+int** oct_decomposition(CSRGraph* graph, signed char* color, int* sizes) {
+	int n = graph->n;
+	sizes[0] = sizes[1] = sizes[2] = 0;
+	for (int i = 0; i < n; i++) {
+		if (color[i] == COLOR_OCT) {
+			++sizes[0];
+		}
+		else if (color[i] == COLOR_LEFT || color[i] == COLOR_RIGHT) {
+			++sizes[1 + color[i]];
+		}
+	}
+
+	int** ret = new int*[3];
+	int fill[3] = {0, 0, 0};
+	for (int k = 0; k < 3; k++) {
+		ret[k] = new int[sizes[k]];
+	}
+
+	for (int i = 0; i < n; i++) {
+		if (color[i] == COLOR_OCT) {
+			ret[0][fill[0]++] = i;
+		}
+		else if (color[i] == COLOR_LEFT || color[i] == COLOR_RIGHT) {
+			ret[1 + color[i]][fill[1 + color[i]]++] = i;
 		}
 	}
 
-	Set** ret = new Set*[3];
-	ret[0] = octset;
-	ret[1] = left;
-	ret[2] = right;
 	return ret;
 }
 
-void remove_indset(Graph* graph, Set* available) {
-	Map<int> deg;
-	Map<Set> revdeg;
+// bucket queue of vertex degrees used to peel independent sets
+struct PeelBuffers {
+	int* deg;
+	int* head;
+	int* next;
+	int* prev;
+	char* active;
 
-	for (Set::Iterator iu = available->begin(); iu != available->end(); ++iu) {
-		int u = *iu;
-		deg[u] = 0;
-		Set* nbrs = graph->neighbors(u);
-		for (Set::Iterator iv = nbrs->begin(); iv != nbrs->end(); ++iv) {
-			int v = *iv;
-			if (available->contains(v)) {
-				deg[u] += 1;
-			}
+	PeelBuffers(int n) {
+		deg = new int[n];
+		head = new int[n + 1];
+		next = new int[n];
+		prev = new int[n];
+		active = new char[n];
+	}
+
+	~PeelBuffers() {
+		delete[] deg;
+		delete[] head;
+		delete[] next;
+		delete[] prev;
+		delete[] active;
+	}
+
+	void insert(int u) {
+		int d = deg[u];
+		prev[u] = -1;
+		next[u] = head[d];
+		if (head[d] != -1) {
+			prev[head[d]] = u;
+		}
+		head[d] = u;
+	}
+
+	void remove(int u) {
+		if (prev[u] != -1) {
+			next[prev[u]] = next[u];
+		}
+		else {
+			head[deg[u]] = next[u];
 		}
 
-		revdeg[deg[u]].insert(u);
+		if (next[u] != -1) {
+			prev[next[u]] = prev[u];
+		}
 	}
+};
 
-	while (deg.size() > 0) {
-		int mindeg;
-		for (mindeg = 0; mindeg <= deg[*(deg.begin())]; ++mindeg) {
-			if (revdeg[mindeg].size() > 0) {
-				break;
-			}
+// removes a maximal independent set from avail, always taking a vertex of
+// minimum degree; order (or index order if NULL) decides ties. returns false
+// if the deadline passed or the caller was cancelled first
+bool remove_indset(CSRGraph* graph, char* avail, int* order, PeelBuffers& b, double deadline) {
+	int n = graph->n;
+	for (int d = 0; d <= n; d++) {
+		b.head[d] = -1;
+	}
+
+	int count = 0;
+	int mindeg = n;
+	for (int i = 0; i < n; i++) {
+		int u = order == NULL ? i : order[i];
+		b.active[u] = avail[u];
+		if (!avail[u]) {
+			continue;
+		}
+
+		int degree = 0;
+		for (int* iv = graph->begin(u); iv != graph->end(u); ++iv) {
+			degree += avail[*iv];
+		}
+
+		b.deg[u] = degree;
+		b.insert(u);
+		mindeg = degree < mindeg ? degree : mindeg;
+		++count;
+	}
+
+	int steps = 0;
+	while (count > 0) {
+		if ((++steps & 1023) == 0 && (cancelled() || (deadline > 0 && wall_time() > deadline))) {
+			return false;
 		}
 
-		int u = *(revdeg[mindeg].begin());
-		revdeg[mindeg].erase(u);
-		deg.erase(u);
-		available->erase(u);
+		while (b.head[mindeg] == -1) {
+			++mindeg;
+		}
+
+		int u = b.head[mindeg];
+		b.remove(u);
+		b.active[u] = 0;
+		avail[u] = 0;
+		--count;
 
-		Set* unbrs = graph->neighbors(u);
-		for (Set::Iterator iv = unbrs->begin(); iv != unbrs->end(); ++iv) {
+		for (int* iv = graph->begin(u); iv != graph->end(u); ++iv) {
 			int v = *iv;
-			if (!deg.contains(v)) {
+			if (!b.active[v]) {
 				continue;
 			}
 
-			revdeg[deg[v]].erase(v);
-			deg.erase(v);
+			b.remove(v);
+			b.active[v] = 0;
+			--count;
 
-			Set* vnbrs = graph->neighbors(v);
-			for (Set::Iterator iw = vnbrs->begin(); iw != vnbrs->end(); ++iw) {
+			for (int* iw = graph->begin(v); iw != graph->end(v); ++iw) {
 				int w = *iw;
-				if (!deg.contains(w)) {
+				if (!b.active[w]) {
 					continue;
 				}
 
-				int degree = deg[w];
-				revdeg[degree].erase(w);
-				deg[w] = degree - 1;
-				revdeg[degree - 1].insert(w);
+				b.remove(w);
+				b.deg[w] -= 1;
+				b.insert(w);
+				mindeg = b.deg[w] < mindeg ? b.deg[w] : mindeg;
 			}
 		}
 	}
+
+	return true;
 }
 
 Set* vertex_delete(Graph* graph) {
+	if (cancelled()) {
+		return NULL;
+	}
+
+	CSRGraph csr(graph);
+	return vertex_delete(&csr);
+}
+
+Set* vertex_delete(CSRGraph* csr) {
+	if (cancelled()) {
+		return NULL;
+	}
+
+	int n = csr->n;
+
+	char* avail = new char[n];
+	for (int i = 0; i < n; i++) {
+		avail[i] = 1;
+	}
+
+	PeelBuffers b(n);
+	if (!remove_indset(csr, avail, NULL, b, 0) || !remove_indset(csr, avail, NULL, b, 0)) {
+		delete[] avail;
+		return NULL;
+	}
+
 	Set* octset = new Set();
-	for (auto it = graph->begin(); it != graph->end(); ++it) {
-		octset->insert(*it);
+	for (int i = 0; i < n; i++) {
+		if (avail[i]) {
+			octset->insert(csr->labels[i]);
+		}
 	}
 
-	remove_indset(graph, octset);
-	remove_indset(graph, octset);
+	delete[] avail;
+	return octset;
+}
+
+// runs vertex_delete from several random tie-breaking orders in parallel and
+// keeps the smallest octset. the first start is the deterministic one and always
+// completes; the others are dropped once the time budget runs out
+Set* vertex_delete_multistart(Graph* graph, int starts, double seconds, int threads) {
+	CSRGraph csr(graph);
+	int n = csr.n;
+	double deadline = seconds > 0 ? wall_time() + seconds : 0;
+
+	char* best = new char[n];
+	int bestsize = n + 1;
+	std::mutex lock;
+
+	parallel_for(starts < 1 ? 1 : starts, [&](int s) {
+		if (s > 0 && deadline > 0 && wall_time() > deadline) {
+			return;
+		}
+
+		int* order = NULL;
+		if (s > 0) {
+			order = new int[n];
+			for (int i = 0; i < n; i++) {
+				order[i] = i;
+			}
+			std::mt19937 rng(s);
+			std::shuffle(order, order + n, rng);
+		}
+
+		char* avail = new char[n];
+		for (int i = 0; i < n; i++) {
+			avail[i] = 1;
+		}
+
+		PeelBuffers b(n);
+		double limit = s > 0 ? deadline : 0;
+		bool done = remove_indset(&csr, avail, order, b, limit) && remove_indset(&csr, avail, order, b, limit);
+
+		if (done) {
+			int size = 0;
+			for (int i = 0; i < n; i++) {
+				size += avail[i];
+			}
+
+			std::lock_guard<std::mutex> guard(lock);
+			if (size < bestsize) {
+				bestsize = size;
+				std::copy(avail, avail + n, best);
+			}
+		}
+
+		delete[] avail;
+		delete[] order;
+	}, threads);
+
+	if (bestsize > n) {
+		delete[] best;
+		return NULL;
+	}
+
+	Set* octset = new Set();
+	for (int i = 0; i < n; i++) {
+		if (best[i]) {
+			octset->insert(csr.labels[i]);
+		}
+	}
 
+	delete[] best;
 	return octset;
 }
@@ -3,10 +3,28 @@
 #define BIPARTITE_H
 
 #include "graph.hpp"
+#include "csr.hpp"
 #include "setmap.hpp"
 
+// vertex colors used by color_bipartite
+#define COLOR_NONE -1
+#define COLOR_LEFT 0
+#define COLOR_RIGHT 1
+#define COLOR_EXCLUDED 2
+#define COLOR_OCT 3
+
 Set* vertex_delete(Graph*);
+Set* vertex_delete(CSRGraph*);
+Set* vertex_delete_multistart(Graph*, int, double, int threads = 0);
+Set* exact_octset(Graph*, int, double, bool* optimal = NULL);
+// reads an octset written by generator.out (text) or write_octset (binary),
+// returning NULL if the file cannot be read
 Set* prescribed_octset(Graph*, const char*);
+// writes an octset compactly as runs of consecutive vertices
+bool write_octset(Set*, const char*);
 Set** verify_bipartite(Graph*, Set*);
+Set** verify_bipartite(CSRGraph*, Set*);
+int color_bipartite(CSRGraph*, signed char*, int threads = 0);
+int** oct_decomposition(CSRGraph*, signed char*, int*);
 
 #endif
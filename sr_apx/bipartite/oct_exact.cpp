@@ -0,0 +1,462 @@
+
+#include "bipartite.hpp"
+#include "cancel.hpp"
+#include "csr.hpp"
+#include "util.hpp"
+
+#include <deque>
+#include <vector>
+
+#define INF 1000000000
+
+// union-find with parity, colors the bipartite part as vertices are added
+struct ParityForest {
+	int* parent;
+	char* parity;
+
+	ParityForest(int n) {
+		parent = new int[n];
+		parity = new char[n];
+	}
+
+	~ParityForest() {
+		delete[] parent;
+		delete[] parity;
+	}
+
+	void reset(int u) {
+		parent[u] = u;
+		parity[u] = 0;
+	}
+
+	int find(int u, int& p) {
+		p = 0;
+		int r = u;
+		while (parent[r] != r) {
+			p ^= parity[r];
+			r = parent[r];
+		}
+
+		// compress the path, keeping parities relative to the root
+		int q = p;
+		while (parent[u] != r && u != r) {
+			int next = parent[u];
+			int nq = q ^ parity[u];
+			parent[u] = r;
+			parity[u] = q;
+			u = next;
+			q = nq;
+		}
+
+		return r;
+	}
+
+	// links u and v so that they get different colors, false on an odd cycle
+	bool link(int u, int v) {
+		int pu, pv;
+		int ru = find(u, pu);
+		int rv = find(v, pv);
+		if (ru == rv) {
+			return pu != pv;
+		}
+
+		parent[ru] = rv;
+		parity[ru] = pu ^ pv ^ 1;
+		return true;
+	}
+};
+
+// unit vertex capacity flow network, rebuilt for every assignment of the octset
+struct CutNetwork {
+	std::vector<int> head;
+	std::vector<int> to;
+	std::vector<int> cap;
+	std::vector<int> next;
+	std::vector<int> touched;
+	std::vector<int> parent;
+	std::vector<char> seen;
+
+	void init(int nodes) {
+		head.assign(nodes, -1);
+		parent.assign(nodes, -1);
+		seen.assign(nodes, 0);
+		to.clear();
+		cap.clear();
+		next.clear();
+	}
+
+	void arc(int u, int v, int c) {
+		to.push_back(v);
+		cap.push_back(c);
+		next.push_back(head[u]);
+		head[u] = to.size() - 1;
+
+		to.push_back(u);
+		cap.push_back(0);
+		next.push_back(head[v]);
+		head[v] = to.size() - 1;
+	}
+
+	// marks the nodes reachable from s in the residual graph, and when t is
+	// among them pushes one unit along the path found
+	bool augment(int s, int t) {
+		for (auto it = touched.begin(); it != touched.end(); ++it) {
+			seen[*it] = 0;
+		}
+		touched.clear();
+
+		std::deque<int> queue;
+		queue.push_back(s);
+		seen[s] = 1;
+		touched.push_back(s);
+
+		while (!queue.empty()) {
+			int current = queue.front();
+			queue.pop_front();
+			for (int e = head[current]; e != -1; e = next[e]) {
+				int v = to[e];
+				if (cap[e] == 0 || seen[v]) {
+					continue;
+				}
+
+				seen[v] = 1;
+				touched.push_back(v);
+				parent[v] = e;
+				if (v == t) {
+					for (int x = t; x != s; x = to[parent[x] ^ 1]) {
+						cap[parent[x]] -= 1;
+						cap[parent[x] ^ 1] += 1;
+					}
+					return true;
+				}
+
+				queue.push_back(v);
+			}
+		}
+
+		return false;
+	}
+};
+
+struct Compressor {
+	CSRGraph* graph;
+	char* active;
+	char* inoct;
+	ParityForest* forest;
+	std::vector<int> octset;
+
+	// side of each octset vertex during enumeration: 0 left, 1 right, 2 deleted
+	std::vector<char> side;
+	// required color of bipartite vertices: -1 none, 0/1 color, 2 conflicting
+	std::vector<char> req;
+	std::vector<int> marked;
+	CutNetwork net;
+
+	double deadline;
+	bool expired;
+	std::vector<int> result;
+
+	bool timed_out() {
+		if (cancelled() || (deadline > 0 && wall_time() > deadline)) {
+			expired = true;
+		}
+		return expired;
+	}
+
+	// checks one complete assignment of the octset, filling result on success
+	bool solve(int deleted) {
+		int budget = octset.size() - 1 - deleted;
+		int n = graph->n;
+
+		for (auto it = marked.begin(); it != marked.end(); ++it) {
+			req[*it] = -1;
+		}
+		marked.clear();
+
+		for (size_t i = 0; i < octset.size(); i++) {
+			if (side[i] == 2) {
+				continue;
+			}
+
+			int x = octset[i];
+			for (int* iw = graph->begin(x); iw != graph->end(x); ++iw) {
+				int w = *iw;
+				if (!active[w] || inoct[w]) {
+					continue;
+				}
+
+				char color = 1 - side[i];
+				if (req[w] == -1) {
+					req[w] = color;
+					marked.push_back(w);
+				}
+				else if (req[w] != color) {
+					req[w] = 2;
+				}
+			}
+		}
+
+		std::vector<int> forced;
+		bool flip = false;
+		bool keep = false;
+		for (auto it = marked.begin(); it != marked.end(); ++it) {
+			int w = *it;
+			if (req[w] == 2) {
+				forced.push_back(w);
+				continue;
+			}
+
+			int p;
+			forest->find(w, p);
+			if (p != req[w]) {
+				flip = true;
+			}
+			else {
+				keep = true;
+			}
+		}
+
+		int limit = budget - (int) forced.size();
+		if (limit < 0) {
+			return false;
+		}
+
+		std::vector<int> cut;
+		if (flip && keep) {
+			int s = 2 * n;
+			int t = 2 * n + 1;
+			net.init(2 * n + 2);
+			for (int u = 0; u < n; u++) {
+				if (!active[u] || inoct[u] || req[u] == 2) {
+					continue;
+				}
+
+				net.arc(2 * u, 2 * u + 1, 1);
+				for (int* iv = graph->begin(u); iv != graph->end(u); ++iv) {
+					int v = *iv;
+					if (active[v] && !inoct[v] && req[v] != 2) {
+						net.arc(2 * u + 1, 2 * v, INF);
+					}
+				}
+
+				if (req[u] != -1) {
+					int p;
+					forest->find(u, p);
+					if (p != req[u]) {
+						net.arc(s, 2 * u, INF);
+					}
+					else {
+						net.arc(2 * u + 1, t, INF);
+					}
+				}
+			}
+
+			int flow = 0;
+			while (net.augment(s, t)) {
+				if (++flow > limit) {
+					return false;
+				}
+			}
+
+			for (auto it = net.touched.begin(); it != net.touched.end(); ++it) {
+				int x = *it;
+				if (x < s && x % 2 == 0 && !net.seen[x + 1]) {
+					cut.push_back(x / 2);
+				}
+			}
+		}
+
+		result.clear();
+		for (size_t i = 0; i < octset.size(); i++) {
+			if (side[i] == 2) {
+				result.push_back(octset[i]);
+			}
+		}
+		result.insert(result.end(), forced.begin(), forced.end());
+		result.insert(result.end(), cut.begin(), cut.end());
+		return true;
+	}
+
+	// assigns octset[i..] to left, right or deleted, skipping assignments with
+	// an edge inside one side and fixing the first kept vertex to the left
+	bool enumerate(size_t i, int deleted, bool anykept) {
+		if (timed_out()) {
+			return false;
+		}
+
+		if (i == octset.size()) {
+			return solve(deleted);
+		}
+
+		int x = octset[i];
+		for (char s = 0; s < 3; s++) {
+			if (s == 1 && !anykept) {
+				continue;
+			}
+
+			if (s == 2) {
+				if (deleted + 1 > (int) octset.size() - 1) {
+					continue;
+				}
+			}
+			else {
+				bool valid = true;
+				for (size_t j = 0; j < i && valid; j++) {
+					if (side[j] != s) {
+						continue;
+					}
+
+					int y = octset[j];
+					for (int* iv = graph->begin(x); iv != graph->end(x); ++iv) {
+						if (*iv == y) {
+							valid = false;
+							break;
+						}
+					}
+				}
+
+				if (!valid) {
+					continue;
+				}
+			}
+
+			side[i] = s;
+			if (enumerate(i + 1, deleted + (s == 2), anykept || s != 2)) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// tries to replace octset by one vertex fewer, rebuilding the coloring
+	bool compress() {
+		side.assign(octset.size(), 0);
+		if (!enumerate(0, 0, false)) {
+			return false;
+		}
+
+		for (auto it = octset.begin(); it != octset.end(); ++it) {
+			inoct[*it] = 0;
+		}
+		octset = result;
+		for (auto it = octset.begin(); it != octset.end(); ++it) {
+			inoct[*it] = 1;
+		}
+
+		for (int u = 0; u < graph->n; u++) {
+			forest->reset(u);
+		}
+		for (int u = 0; u < graph->n; u++) {
+			if (!active[u] || inoct[u]) {
+				continue;
+			}
+
+			for (int* iv = graph->begin(u); iv != graph->end(u); ++iv) {
+				if (*iv < u && active[*iv] && !inoct[*iv]) {
+					forest->link(u, *iv);
+				}
+			}
+		}
+
+		return true;
+	}
+
+	// adds u to the bipartite part if that keeps it bipartite
+	bool extend(int u) {
+		std::vector<int> roots;
+		std::vector<int> colors;
+		for (int* iv = graph->begin(u); iv != graph->end(u); ++iv) {
+			int v = *iv;
+			if (!active[v] || inoct[v] || v == u) {
+				continue;
+			}
+
+			int p;
+			int r = forest->find(v, p);
+			for (size_t j = 0; j < roots.size(); j++) {
+				if (roots[j] == r && colors[j] == p) {
+					return false;
+				}
+			}
+			roots.push_back(r);
+			colors.push_back(p ^ 1);
+		}
+
+		for (int* iv = graph->begin(u); iv != graph->end(u); ++iv) {
+			int v = *iv;
+			if (active[v] && !inoct[v] && v != u) {
+				forest->link(u, v);
+			}
+		}
+		return true;
+	}
+};
+
+// computes a minimum octset by iterative compression, adding vertices one at
+// a time and compressing whenever the octset grows. if the minimum exceeds k
+// or the time budget runs out, falls back to vertex_delete
+Set* exact_octset(Graph* graph, int k, double seconds, bool* optimal) {
+	CSRGraph csr(graph);
+	int n = csr.n;
+
+	Compressor c;
+	c.graph = &csr;
+	c.active = new char[n];
+	c.inoct = new char[n];
+	c.forest = new ParityForest(n);
+	c.req.assign(n, -1);
+	c.deadline = seconds > 0 ? wall_time() + seconds : 0;
+	c.expired = false;
+
+	for (int u = 0; u < n; u++) {
+		c.active[u] = 0;
+		c.inoct[u] = 0;
+		c.forest->reset(u);
+	}
+
+	bool success = true;
+	for (int u = 0; u < n && success; u++) {
+		c.active[u] = 1;
+		if (c.extend(u)) {
+			continue;
+		}
+
+		c.octset.push_back(u);
+		c.inoct[u] = 1;
+		if ((int) c.octset.size() > k) {
+			if (!c.compress()) {
+				success = false;
+			}
+		}
+		else {
+			c.compress();
+		}
+
+		if (c.expired) {
+			success = false;
+		}
+	}
+
+	Set* octset = NULL;
+	if (success) {
+		octset = new Set();
+		for (auto it = c.octset.begin(); it != c.octset.end(); ++it) {
+			octset->insert(csr.labels[*it]);
+		}
+	}
+
+	delete[] c.active;
+	delete[] c.inoct;
+	delete c.forest;
+
+	if (optimal != NULL) {
+		*optimal = success;
+	}
+
+	if (!success) {
+		return cancelled() ? NULL : vertex_delete(graph);
+	}
+
+	return octset;
+}
@@ -0,0 +1,6 @@
+
+# the results are Graphs and Sets, whose types are readied by these modules
+import sr_apx.graph
+import sr_apx.setmap
+
+from .lib_generate import generate_oct, planted_octset, write_oct_graph
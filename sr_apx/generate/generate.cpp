@@ -0,0 +1,225 @@
+#include "generate.hpp"
+#include "parallel.hpp"
+#include "bipartite.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// rows of the generator (right and oct vertices) drawn from one stream
+#define BLOCK_ROWS 64
+
+// splitmix64. each block gets its own stream, mixed from the seed and the
+// block index
+class Random {
+public:
+	unsigned long state;
+	bool cached;
+	double spare;
+
+	Random(unsigned long seed, unsigned long stream) : cached(false), spare(0) {
+		state = seed;
+		state = next() ^ (stream * 0xd1342543de82ef95UL);
+		next();
+	};
+
+	unsigned long next() {
+		unsigned long z = (state += 0x9e3779b97f4a7c15UL);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9UL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebUL;
+		return z ^ (z >> 31);
+	}
+
+	// uniform in [0, 1)
+	double uniform() {
+		return (next() >> 11) * (1.0 / 9007199254740992.0);
+	}
+
+	// the polar form of the box muller transform, as in the generator
+	double normal(double mean, double std) {
+		if (cached) {
+			cached = false;
+			return mean + spare * std;
+		}
+
+		double x1, x2, w;
+		do {
+			x1 = 2.0 * uniform() - 1.0;
+			x2 = 2.0 * uniform() - 1.0;
+			w = x1 * x1 + x2 * x2;
+		} while (w >= 1.0 || w == 0.0);
+
+		w = sqrt((-2.0 * log(w)) / w);
+		spare = x2 * w;
+		cached = true;
+		return mean + x1 * w * std;
+	}
+};
+
+// calls f(i) for each i in [0, n) with probability p, skipping over the
+// misses with geometrically distributed gaps
+template <typename F>
+void sample(Random& random, long n, double p, F f) {
+	if (!(p > 0)) {
+		return;
+	}
+	if (p >= 1) {
+		for (long i = 0; i < n; i++) {
+			f(i);
+		}
+		return;
+	}
+
+	double scale = 1.0 / log1p(-p);
+	long i = -1;
+	while (true) {
+		double gap = floor(log1p(-random.uniform()) * scale);
+		if (gap >= n - i - 1) {
+			return;
+		}
+		i += 1 + (long) gap;
+		f(i);
+	}
+}
+
+bool valid_params(const OctParams& params) {
+	return params.left >= 0 && params.right >= 0 && params.oct >= 0 && (long) params.left + params.right + params.oct <= INT_MAX;
+}
+
+CSRGraph* generate_oct(const OctParams& params, int threads) {
+	if (!valid_params(params)) {
+		return NULL;
+	}
+
+	int bip = params.left + params.right;
+	int total = bip + params.oct;
+
+	double oct_mean = params.octg * bip;
+	double oct_std = params.octgcv * oct_mean;
+	if (params.octgcv > 1) {
+		oct_mean -= oct_std * .3187 / .7475 / 2;
+	}
+
+	// blocks of right rows come first, then blocks of oct rows
+	int rightblocks = (params.right + BLOCK_ROWS - 1) / BLOCK_ROWS;
+	int blocks = rightblocks + (params.oct + BLOCK_ROWS - 1) / BLOCK_ROWS;
+	std::vector<std::vector<int>> edges(blocks);
+	parallel_for(blocks, [&](int b) {
+		Random random(params.seed, b);
+		std::vector<int>& out = edges[b];
+		if (b < rightblocks) {
+			int end = std::min(params.right, (b + 1) * BLOCK_ROWS);
+			for (int r = b * BLOCK_ROWS; r < end; r++) {
+				int v = params.left + r;
+				double p = random.normal(params.mean, params.std) / params.left;
+				sample(random, params.left, p, [&](long u) {
+					out.push_back(u);
+					out.push_back(v);
+				});
+			}
+		}
+		else {
+			int start = (b - rightblocks) * BLOCK_ROWS;
+			int end = std::min(params.oct, start + BLOCK_ROWS);
+			for (int o = start; o < end; o++) {
+				int v = bip + o;
+				double p = random.normal(oct_mean, oct_std) / bip;
+				sample(random, bip, p, [&](long u) {
+					out.push_back(u);
+					out.push_back(v);
+				});
+				sample(random, o, params.octoct, [&](long j) {
+					out.push_back(bip + j);
+					out.push_back(v);
+				});
+			}
+		}
+	}, threads);
+
+	// degrees, then the offsets of the vertices that have edges
+	std::vector<std::atomic<long>> position(total);
+	parallel_for(blocks, [&](int b) {
+		for (auto it = edges[b].begin(); it != edges[b].end(); ++it) {
+			position[*it].fetch_add(1, std::memory_order_relaxed);
+		}
+	}, threads);
+
+	std::vector<int> index(total, -1);
+	int n = 0;
+	for (int i = 0; i < total; i++) {
+		if (position[i] > 0) {
+			index[i] = n++;
+		}
+	}
+
+	CSRGraph* csr = new CSRGraph();
+	csr->n = n;
+	csr->offsets = new long[n + 1];
+	csr->labels = new int[n];
+	csr->offsets[0] = 0;
+	for (int i = 0; i < total; i++) {
+		int k = index[i];
+		if (k >= 0) {
+			csr->labels[k] = i;
+			csr->offsets[k + 1] = csr->offsets[k] + position[i];
+			position[i] = csr->offsets[k];
+		}
+	}
+	csr->m = csr->offsets[n];
+	csr->nbrs = new int[csr->m];
+
+	// the neighbors land in any order and are sorted afterwards, so that the
+	// csr does not depend on the threads either
+	parallel_for(blocks, [&](int b) {
+		std::vector<int>& e = edges[b];
+		for (size_t i = 0; i < e.size(); i += 2) {
+			csr->nbrs[position[e[i]]++] = index[e[i + 1]];
+			csr->nbrs[position[e[i + 1]]++] = index[e[i]];
+		}
+		std::vector<int>().swap(e);
+	}, threads);
+
+	int chunks = std::max(1, std::min(n / 1024, 8 * (threads > 0 ? threads : num_threads())));
+	parallel_for(chunks, [&](int c) {
+		int end = (long) n * (c + 1) / chunks;
+		for (int i = (long) n * c / chunks; i < end; i++) {
+			std::sort(csr->begin(i), csr->end(i));
+		}
+	}, threads);
+
+	return csr;
+}
+
+Set* planted_octset(const OctParams& params) {
+	if (!valid_params(params)) {
+		return NULL;
+	}
+
+	Set* octset = new Set();
+	int bip = params.left + params.right;
+	for (int o = 0; o < params.oct; o++) {
+		octset->insert(bip + o);
+	}
+	return octset;
+}
+
+bool write_oct_graph(const OctParams& params, const char* name, int threads) {
+	CSRGraph* csr = generate_oct(params, threads);
+	if (csr == NULL) {
+		return false;
+	}
+
+	bool written = write_sparse6(csr, (std::string(name) + ".s6").c_str(), threads);
+	delete csr;
+	if (!written) {
+		return false;
+	}
+
+	Set* octset = planted_octset(params);
+	written = write_octset(octset, (std::string(name) + ".oct").c_str());
+	delete octset;
+	return written;
+}
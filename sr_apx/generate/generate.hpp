@@ -0,0 +1,47 @@
+
+#ifndef GENERATE_H
+#define GENERATE_H
+
+#include "graph.hpp"
+#include "csr.hpp"
+#include "setmap.hpp"
+
+// the parameters of generator/OCTgenerator.c. a random bipartite graph on
+// left and right vertices, where each right vertex picks a degree from a
+// normal distribution (mean, std) and left neighbors uniformly, and oct more
+// vertices with degrees around octg * (left + right) (coefficient of
+// variation octgcv) into the bipartite part and density octoct among
+// themselves
+struct OctParams {
+	int left;
+	int right;
+	double mean;
+	double std;
+	int oct;
+	double octoct;
+	double octg;
+	double octgcv;
+	unsigned long seed;
+};
+
+// false if a size is negative or the vertices do not fit in an int
+bool valid_params(const OctParams&);
+
+// generates the graph in memory as a csr, with labels 0..left-1 on the left,
+// then the right and then the oct vertices, and without isolated vertices as
+// in Graph. the rows of the generator are drawn in blocks on threads (as in
+// parallel_for), each block from its own random stream derived from the seed,
+// so the graph depends only on the parameters and not on the threads. edges
+// are found by geometric skipping, in time linear in their number. returns
+// NULL for parameters that are not valid_params
+CSRGraph* generate_oct(const OctParams&, int threads = 0);
+
+// the planted octset, the last oct labels, or NULL as for generate_oct
+Set* planted_octset(const OctParams&);
+
+// writes name.s6 and the planted octset to name.oct, in the binary format of
+// write_octset. returns false for parameters that are not valid_params or if
+// a file cannot be written
+bool write_oct_graph(const OctParams&, const char* name, int threads = 0);
+
+#endif
@@ -0,0 +1,97 @@
+#include <Python.h>
+
+#include "generate.hpp"
+#include "pygraph.hpp"
+#include "pyset.hpp"
+#include "pycall.hpp"
+
+// the arguments of generate_oct, after any taken by the caller
+#define OCT_FORMAT "iiddiddd|ki"
+#define OCT_KEYWORDS "left", "right", "mean", "std", "oct", "octoct", "octg", "octgcv", "seed", "threads"
+
+// sets a ValueError and returns false for sizes generate_oct rejects
+static bool check_params(const OctParams& params) {
+	if (!valid_params(params)) {
+		PyErr_SetString(PyExc_ValueError, "left, right and oct must be nonnegative and their sum must fit in an int");
+		return false;
+	}
+	return true;
+}
+
+static PyObject* generate_generateoct(PyObject* self, PyObject* args, PyObject* kwargs) {
+	static const char* keywords[] = {OCT_KEYWORDS, NULL};
+	OctParams params;
+	params.seed = 0;
+	int threads = 0;
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, OCT_FORMAT, (char**) keywords, &params.left, &params.right,
+		&params.mean, &params.std, &params.oct, &params.octoct, &params.octg, &params.octgcv, &params.seed, &threads) || !check_params(params)) {
+		return NULL;
+	}
+
+	CSRGraph* csr;
+	{
+		WithoutGIL nogil({});
+		csr = generate_oct(params, threads);
+	}
+	return make_PyGraph(csr);
+}
+
+static PyObject* generate_plantedoctset(PyObject* self, PyObject* args) {
+	OctParams params;
+	if (!PyArg_ParseTuple(args, "iii", &params.left, &params.right, &params.oct) || !check_params(params)) {
+		return NULL;
+	}
+
+	return make_PySet(planted_octset(params), false);
+}
+
+static PyObject* generate_writeoctgraph(PyObject* self, PyObject* args, PyObject* kwargs) {
+	static const char* keywords[] = {"name", OCT_KEYWORDS, NULL};
+	PyObject* bytes;
+	OctParams params;
+	params.seed = 0;
+	int threads = 0;
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&" OCT_FORMAT, (char**) keywords, PyUnicode_FSConverter, &bytes,
+		&params.left, &params.right, &params.mean, &params.std, &params.oct, &params.octoct, &params.octg, &params.octgcv,
+		&params.seed, &threads)) {
+		return NULL;
+	}
+	if (!check_params(params)) {
+		Py_DECREF(bytes);
+		return NULL;
+	}
+
+	const char* name = PyBytes_AS_STRING(bytes);
+	bool written;
+	{
+		WithoutGIL nogil({});
+		written = write_oct_graph(params, name, threads);
+	}
+	if (!written) {
+		PyErr_Format(PyExc_OSError, "could not write '%s.s6' and '%s.oct'", name, name);
+	}
+	Py_DECREF(bytes);
+	if (!written) {
+		return NULL;
+	}
+	Py_RETURN_NONE;
+}
+
+static PyMethodDef generate_methods[] = {
+	{"generate_oct", (PyCFunction) generate_generateoct, METH_VARARGS | METH_KEYWORDS, "generates a random bipartite graph plus an octset in memory, drawing blocks of vertices in parallel"},
+	{"planted_octset", generate_plantedoctset, METH_VARARGS, "gets the octset planted by generate_oct for the given left, right and oct sizes"},
+	{"write_oct_graph", (PyCFunction) generate_writeoctgraph, METH_VARARGS | METH_KEYWORDS, "generates a graph as generate_oct does and writes it to name.s6 and its octset to name.oct"},
+	{NULL},
+};
+
+static struct PyModuleDef generate_module = {
+	PyModuleDef_HEAD_INIT,
+	"generate",
+	"Python interface for generating graphs with a planted octset",
+	-1,
+	generate_methods
+};
+
+PyMODINIT_FUNC PyInit_lib_generate() {
+	return PyModule_Create(&generate_module);
+}
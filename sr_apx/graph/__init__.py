@@ -1,2 +1,2 @@
 
-from .lib_graph import Graph, read_sparse6, read_edge_list
+from .lib_graph import Graph, read_sparse6, read_edge_list, read_graph, read_metis, read_dimacs, read_matrix_market, read_snap, write_sparse6, write_graph6, share_graph, attach_graph, unshare_graph
@@ -0,0 +1,378 @@
+
+#include "csr.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CSR_MAGIC "SRAPXCSR"
+
+// a csr file is this header followed by offsets[n + 1], labels[n] and nbrs[m]
+struct CSRHeader {
+	char magic[8];
+	long n;
+	long m;
+};
+
+CSRGraph::CSRGraph(Graph* graph) {
+	mapped = NULL;
+	length = 0;
+	n = graph->size();
+	offsets = new long[n + 1];
+	labels = new int[n];
+
+	Map<int> index;
+	index.reserve(n);
+
+	int i = 0;
+	offsets[0] = 0;
+	for (auto iu = graph->begin(); iu != graph->end(); ++iu) {
+		labels[i] = *iu;
+		index[*iu] = i;
+		offsets[i + 1] = offsets[i] + iu->value.size();
+		++i;
+	}
+
+	m = offsets[n];
+	nbrs = new int[m];
+	for (i = 0; i < n; i++) {
+		Set* adj = graph->neighbors(labels[i]);
+		long j = offsets[i];
+		for (Set::Iterator iv = adj->begin(); iv != adj->end(); ++iv) {
+			nbrs[j++] = index.find(*iv)->value;
+		}
+	}
+}
+
+Graph::Graph(CSRGraph* csr) {
+	adjlist.reserve(csr->n);
+	for (int i = 0; i < csr->n; i++) {
+		Set& adj = adjlist[csr->labels[i]];
+		adj.reserve(csr->degree(i));
+		for (int* iv = csr->begin(i); iv != csr->end(i); ++iv) {
+			adj.insert(csr->labels[*iv]);
+		}
+	}
+}
+
+CSRGraph::~CSRGraph() {
+	if (mapped != NULL) {
+		munmap(mapped, length);
+		return;
+	}
+
+	delete[] offsets;
+	delete[] nbrs;
+	delete[] labels;
+}
+
+// madvise on the pages spanning [start, start + bytes)
+void advise_range(void* start, size_t bytes, int advice) {
+	long page = sysconf(_SC_PAGESIZE);
+	char* first = (char*) ((size_t) start & ~(size_t) (page - 1));
+	madvise(first, (char*) start + bytes - first, advice);
+}
+
+void CSRGraph::advise(bool sequential) {
+	if (mapped != NULL && m > 0) {
+		advise_range(nbrs, m * sizeof(int), sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+	}
+}
+
+size_t csr_length(long n, long m) {
+	return sizeof(CSRHeader) + (n + 1) * sizeof(long) + n * sizeof(int) + m * sizeof(int);
+}
+
+// creates a file of the given length and maps it for writing
+void* map_new(const char* filename, size_t bytes) {
+	int fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		return NULL;
+	}
+
+	void* base = MAP_FAILED;
+	if (ftruncate(fd, bytes) == 0) {
+		base = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	close(fd);
+	return base == MAP_FAILED ? NULL : base;
+}
+
+bool write_csr(const char* input, const char* output) {
+	// pass 1: degrees, without self loops
+	std::vector<long> degree;
+	long total = 0;
+	int reported = stream_graph(input, [&](int u, int v) {
+		if (u == v) {
+			return;
+		}
+
+		int top = (u > v ? u : v) + 1;
+		if ((int) degree.size() < top) {
+			degree.resize(top, 0);
+		}
+		++degree[u];
+		++degree[v];
+		total += 2;
+	});
+	if (reported < 0) {
+		return false;
+	}
+	// ids past a header's vertex count still get rows
+	int count = std::max(reported, (int) degree.size());
+	degree.resize(count, 0);
+
+	// pass 2: scatter the edges into a scratch file indexed by label
+	std::vector<long> offsets(count + 1, 0);
+	for (int u = 0; u < count; u++) {
+		offsets[u + 1] = offsets[u] + degree[u];
+	}
+
+	std::string scratch = std::string(output) + ".tmp";
+	size_t scratchbytes = (total > 0 ? total : 1) * sizeof(int);
+	int* adj = (int*) map_new(scratch.c_str(), scratchbytes);
+	if (adj == NULL) {
+		return false;
+	}
+
+	// the file must read the same as in pass 1, or the rows are left short
+	// and the stale csr is removed
+	std::vector<long> pos(offsets.begin(), offsets.end() - 1);
+	bool changed = false;
+	int again = stream_graph(input, [&](int u, int v) {
+		if (u == v) {
+			return;
+		}
+		if (u >= count || v >= count || pos[u] == offsets[u + 1] || pos[v] == offsets[v + 1]) {
+			changed = true;
+			return;
+		}
+		adj[pos[u]++] = v;
+		adj[pos[v]++] = u;
+	});
+	for (int u = 0; u < count && !changed; u++) {
+		changed = pos[u] != offsets[u + 1];
+	}
+	std::vector<long>().swap(pos);
+	if (again != reported || changed) {
+		munmap(adj, scratchbytes);
+		unlink(scratch.c_str());
+		unlink(output);
+		return false;
+	}
+
+	// duplicate edges are dropped within each row
+	long m = 0;
+	int n = 0;
+	for (int u = 0; u < count; u++) {
+		int* first = adj + offsets[u];
+		int* last = adj + offsets[u + 1];
+		std::sort(first, last);
+		degree[u] = std::unique(first, last) - first;
+		m += degree[u];
+		n += degree[u] > 0;
+	}
+
+	// breadth first order over the non-isolated vertices
+	std::vector<int> order;
+	std::vector<int> rank(count, -1);
+	order.reserve(n);
+	for (int s = 0; s < count; s++) {
+		if (degree[s] == 0 || rank[s] != -1) {
+			continue;
+		}
+
+		rank[s] = order.size();
+		order.push_back(s);
+		for (size_t h = rank[s]; h < order.size(); h++) {
+			int u = order[h];
+			for (int* iv = adj + offsets[u]; iv != adj + offsets[u] + degree[u]; ++iv) {
+				if (rank[*iv] == -1) {
+					rank[*iv] = order.size();
+					order.push_back(*iv);
+				}
+			}
+		}
+	}
+
+	size_t bytes = csr_length(n, m);
+	char* base = (char*) map_new(output, bytes);
+	if (base == NULL) {
+		munmap(adj, scratchbytes);
+		unlink(scratch.c_str());
+		return false;
+	}
+
+	CSRHeader* header = (CSRHeader*) base;
+	memcpy(header->magic, CSR_MAGIC, 8);
+	header->n = n;
+	header->m = m;
+	long* outoffsets = (long*) (header + 1);
+	int* outlabels = (int*) (outoffsets + n + 1);
+	int* outnbrs = outlabels + n;
+
+	outoffsets[0] = 0;
+	for (int i = 0; i < n; i++) {
+		int u = order[i];
+		outlabels[i] = u;
+		outoffsets[i + 1] = outoffsets[i] + degree[u];
+
+		int* row = outnbrs + outoffsets[i];
+		for (long j = 0; j < degree[u]; j++) {
+			row[j] = rank[adj[offsets[u] + j]];
+		}
+		std::sort(row, row + degree[u]);
+	}
+
+	munmap(adj, scratchbytes);
+	unlink(scratch.c_str());
+	msync(base, bytes, MS_SYNC);
+	munmap(base, bytes);
+	return true;
+}
+
+// maps an open csr file or shared memory object read-only and closes it
+CSRGraph* map_fd(int fd) {
+	struct stat st;
+	void* base = MAP_FAILED;
+	if (fstat(fd, &st) == 0 && st.st_size >= (off_t) sizeof(CSRHeader)) {
+		base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	}
+	close(fd);
+	if (base == MAP_FAILED) {
+		return NULL;
+	}
+
+	CSRHeader* header = (CSRHeader*) base;
+	if (memcmp(header->magic, CSR_MAGIC, 8) != 0 || header->n < 0 || header->m < 0 ||
+		csr_length(header->n, header->m) != (size_t) st.st_size) {
+		munmap(base, st.st_size);
+		return NULL;
+	}
+
+	CSRGraph* graph = new CSRGraph();
+	graph->n = header->n;
+	graph->m = header->m;
+	graph->offsets = (long*) (header + 1);
+	graph->labels = (int*) (graph->offsets + graph->n + 1);
+	graph->nbrs = graph->labels + graph->n;
+	graph->mapped = base;
+	graph->length = st.st_size;
+
+	// offsets and labels are read for every vertex, so fetch them ahead
+	advise_range(graph->offsets, (char*) graph->nbrs - (char*) graph->offsets, MADV_WILLNEED);
+	return graph;
+}
+
+// true if the file was modified before source, or either is missing
+bool older(const char* filename, const char* source) {
+	struct stat st, src;
+	if (stat(filename, &st) != 0 || stat(source, &src) != 0) {
+		return true;
+	}
+
+	if (st.st_mtim.tv_sec != src.st_mtim.tv_sec) {
+		return st.st_mtim.tv_sec < src.st_mtim.tv_sec;
+	}
+	return st.st_mtim.tv_nsec < src.st_mtim.tv_nsec;
+}
+
+CSRGraph* map_csr(const char* filename, const char* source) {
+	if (source != NULL && older(filename, source)) {
+		return NULL;
+	}
+
+	int fd = open(filename, O_RDONLY);
+	if (fd < 0) {
+		return NULL;
+	}
+
+	return map_fd(fd);
+}
+
+size_t csr_bytes(CSRGraph* graph) {
+	return csr_length(graph->n, graph->m);
+}
+
+void pack_csr(CSRGraph* graph, void* out) {
+	CSRHeader* header = (CSRHeader*) out;
+	header->n = graph->n;
+	header->m = graph->m;
+	long* offsets = (long*) (header + 1);
+	int* labels = (int*) (offsets + graph->n + 1);
+	int* nbrs = labels + graph->n;
+	memcpy(offsets, graph->offsets, (graph->n + 1) * sizeof(long));
+	memcpy(labels, graph->labels, graph->n * sizeof(int));
+	memcpy(nbrs, graph->nbrs, graph->m * sizeof(int));
+
+	// the magic goes in last so that a process attaching early sees no graph
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	memcpy(header->magic, CSR_MAGIC, 8);
+}
+
+CSRGraph* unpack_csr(const void* data, size_t bytes) {
+	CSRHeader header;
+	if (bytes < sizeof(CSRHeader)) {
+		return NULL;
+	}
+	memcpy(&header, data, sizeof(CSRHeader));
+	if (memcmp(header.magic, CSR_MAGIC, 8) != 0 || header.n < 0 || header.m < 0 || csr_length(header.n, header.m) != bytes) {
+		return NULL;
+	}
+
+	// the buffer need not be aligned, so the arrays are copied out of it
+	const char* p = (const char*) data + sizeof(CSRHeader);
+	CSRGraph* graph = new CSRGraph();
+	graph->n = header.n;
+	graph->m = header.m;
+	graph->offsets = new long[graph->n + 1];
+	graph->labels = new int[graph->n];
+	graph->nbrs = new int[graph->m];
+	memcpy(graph->offsets, p, (graph->n + 1) * sizeof(long));
+	p += (graph->n + 1) * sizeof(long);
+	memcpy(graph->labels, p, graph->n * sizeof(int));
+	p += graph->n * sizeof(int);
+	memcpy(graph->nbrs, p, graph->m * sizeof(int));
+	return graph;
+}
+
+bool share_csr(CSRGraph* graph, const char* name) {
+	int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+	if (fd < 0) {
+		return false;
+	}
+
+	size_t bytes = csr_length(graph->n, graph->m);
+	void* base = MAP_FAILED;
+	if (ftruncate(fd, bytes) == 0) {
+		base = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	close(fd);
+	if (base == MAP_FAILED) {
+		shm_unlink(name);
+		return false;
+	}
+
+	pack_csr(graph, base);
+	munmap(base, bytes);
+	return true;
+}
+
+CSRGraph* attach_csr(const char* name) {
+	int fd = shm_open(name, O_RDONLY, 0);
+	if (fd < 0) {
+		return NULL;
+	}
+
+	return map_fd(fd);
+}
+
+bool unshare_csr(const char* name) {
+	return shm_unlink(name) == 0;
+}
@@ -0,0 +1,67 @@
+
+#ifndef CSR_H
+#define CSR_H
+
+#include <cstddef>
+
+#include "graph.hpp"
+#include "setmap.hpp"
+
+// compact, read-only snapshot of a Graph with vertices relabeled 0..n-1. the
+// arrays are either owned or point into a file mapped by map_csr
+class CSRGraph {
+public:
+	int n;
+	long m;
+	long* offsets;
+	int* nbrs;
+	int* labels;
+
+	void* mapped;
+	size_t length;
+
+	CSRGraph() : n(0), m(0), offsets(NULL), nbrs(NULL), labels(NULL), mapped(NULL), length(0) {};
+	CSRGraph(Graph*);
+	~CSRGraph();
+
+	int degree(int u) {return offsets[u + 1] - offsets[u];};
+	int* begin(int u) {return nbrs + offsets[u];};
+	int* end(int u) {return nbrs + offsets[u + 1];};
+
+	// tells the kernel whether the adjacency of a mapped graph is about to be
+	// read front to back or in random order
+	void advise(bool sequential);
+};
+
+// writes the csr of a sparse6 file (.s6) or edge list to output, keeping only
+// per-vertex arrays in memory. vertices are renumbered in breadth first order
+// so that neighbors tend to share pages, and isolated vertices are dropped as
+// in Graph. returns false if a file cannot be read or written
+bool write_csr(const char* input, const char* output);
+
+// maps a file written by write_csr, leaving the paging to the os. returns NULL
+// if it is not one, or if it is older than the source file it was written from
+CSRGraph* map_csr(const char*, const char* source = NULL);
+
+// size of a csr in the layout of a csr file, and writing it to that many
+// bytes at out. unpack_csr copies a csr back out of such a buffer, which
+// need not be aligned, and returns NULL if it is not one
+size_t csr_bytes(CSRGraph*);
+void pack_csr(CSRGraph*, void* out);
+CSRGraph* unpack_csr(const void*, size_t);
+
+// copies a csr into a new posix shared memory object with the layout of a csr
+// file, so that other processes can attach to it by name. returns false if the
+// name is taken or the object cannot be created
+bool share_csr(CSRGraph*, const char* name);
+
+// maps a shared csr read-only. every process attached to it reads the same
+// pages, and it stays valid after unshare_csr until the graph is deleted.
+// returns NULL if there is no such object or it is not a csr
+CSRGraph* attach_csr(const char* name);
+
+// removes the name of a shared csr, its memory is freed once the last
+// attached process lets go of it
+bool unshare_csr(const char* name);
+
+#endif
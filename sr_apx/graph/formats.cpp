@@ -0,0 +1,638 @@
+
+#include "formats.hpp"
+#include "parallel.hpp"
+#include "input.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// files smaller than this are parsed in one piece
+#define PIECE_MIN (1 << 20)
+
+// a text file mapped read-only, or for a compressed file its decompressed
+// contents in memory, for the readers that parse pieces of it on threads
+class TextFile {
+public:
+	const char* data;
+	size_t length;
+	bool ok;
+	std::vector<char> inflated;
+
+	TextFile(const char*);
+	~TextFile();
+
+	const char* end() {return data + length;};
+};
+
+TextFile::TextFile(const char* filename) : data(NULL), length(0), ok(false) {
+	if (compressed(filename)) {
+		InputFile f(filename);
+		ok = f.is_open();
+		while (ok && f) {
+			size_t start = inflated.size();
+			inflated.resize(start + PIECE_MIN);
+			f.read(inflated.data() + start, PIECE_MIN);
+			inflated.resize(start + f.gcount());
+		}
+		ok = ok && !f.bad();
+		length = inflated.size();
+		data = length > 0 ? inflated.data() : NULL;
+		return;
+	}
+
+	int fd = open(filename, O_RDONLY);
+	if (fd < 0) {
+		return;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) == 0) {
+		ok = true;
+		length = st.st_size;
+		if (length > 0) {
+			void* base = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (base == MAP_FAILED) {
+				ok = false;
+				length = 0;
+			}
+			else {
+				madvise(base, length, MADV_SEQUENTIAL);
+				data = (const char*) base;
+			}
+		}
+	}
+	close(fd);
+}
+
+TextFile::~TextFile() {
+	if (data != NULL && inflated.empty()) {
+		munmap((void*) data, length);
+	}
+}
+
+// the start of the line after the one containing p
+static const char* next_line(const char* p, const char* end) {
+	const char* newline = (const char*) memchr(p, '\n', end - p);
+	return newline == NULL ? end : newline + 1;
+}
+
+static const char* skip_blanks(const char* p, const char* end) {
+	while (p < end && (*p == ' ' || *p == '\t' || *p == ',' || *p == '\r')) {
+		++p;
+	}
+	return p;
+}
+
+// reads the next number on the line into x and moves p past it. returns false
+// at the end of the line or at a token that is not a nonnegative integer.
+// numbers far too large for an id stop growing instead of overflowing
+static bool next_number(const char*& p, const char* end, long& x) {
+	p = skip_blanks(p, end);
+	if (p == end || *p < '0' || *p > '9') {
+		return false;
+	}
+
+	x = 0;
+	while (p < end && *p >= '0' && *p <= '9') {
+		if (x <= LONG_MAX / 100) {
+			x = 10 * x + (*p - '0');
+		}
+		++p;
+	}
+	return true;
+}
+
+// the ids are passed on as ints, and the number of vertices must fit in one
+static bool valid_id(long x) {
+	return x >= 0 && x < INT_MAX;
+}
+
+// true for lines that are blank or start with one of the comment characters
+static bool skipped_line(const char* p, const char* end, const char* comments) {
+	p = skip_blanks(p, end);
+	return p == end || *p == '\n' || strchr(comments, *p) != NULL;
+}
+
+// splits [begin, end) into pieces that start at line starts
+static std::vector<const char*> split_lines(const char* begin, const char* end, int pieces) {
+	std::vector<const char*> bounds(1, begin);
+	for (int i = 1; i < pieces; i++) {
+		const char* p = begin + (end - begin) * i / pieces;
+		p = p == begin ? begin : next_line(p - 1, end);
+		bounds.push_back(std::max(p, bounds.back()));
+	}
+	bounds.push_back(end);
+	return bounds;
+}
+
+// edge(piece, u, v) is called from the thread parsing that piece
+typedef std::function<void(int, int, int)> PieceEdge;
+
+// the lines of each format, parsed by the scanners below and by LineScanner.
+// the line ends at end or at its newline. those that pass edges on return
+// false at an id that does not fit in an int
+
+template <typename F>
+static bool snap_line(const char* p, const char* end, long& top, const F& edge) {
+	if (skipped_line(p, end, "#%")) {
+		return true;
+	}
+
+	long u, v;
+	if (next_number(p, end, u) && next_number(p, end, v)) {
+		if (!valid_id(u) || !valid_id(v)) {
+			return false;
+		}
+		edge(u, v);
+		top = std::max(top, std::max(u, v) + 1);
+	}
+	return true;
+}
+
+// an "e u v" edge, or "p <problem> n m" setting n
+template <typename F>
+static bool dimacs_line(const char* p, const char* end, long& n, const F& edge) {
+	p = skip_blanks(p, end);
+	if (p == end) {
+		return true;
+	}
+
+	long u, v;
+	if (*p == 'e') {
+		++p;
+		if (next_number(p, end, u) && next_number(p, end, v) && u > 0 && v > 0) {
+			if (!valid_id(u - 1) || !valid_id(v - 1)) {
+				return false;
+			}
+			edge(u - 1, v - 1);
+		}
+	}
+	else if (*p == 'p') {
+		p = skip_blanks(p + 1, end);
+		while (p < end && isalpha(*p)) {
+			++p;
+		}
+		if (next_number(p, end, u)) {
+			n = u;
+		}
+	}
+	return true;
+}
+
+struct MetisHeader {
+	long n;
+	int skip;
+	bool edgeweights;
+};
+
+// n m [fmt [ncon]], where the digits of fmt flag vertex sizes, vertex
+// weights and edge weights
+static bool metis_header(const char* p, const char* end, MetisHeader& header) {
+	long m;
+	long fmt = 0;
+	long ncon = 1;
+	if (!next_number(p, end, header.n) || !next_number(p, end, m) || header.n > INT_MAX) {
+		return false;
+	}
+	if (next_number(p, end, fmt)) {
+		next_number(p, end, ncon);
+	}
+	header.skip = (fmt / 100 % 10 ? 1 : 0) + (fmt / 10 % 10 ? ncon : 0);
+	header.edgeweights = fmt % 10;
+	return true;
+}
+
+// comments after the header are not vertices, blank lines are
+static bool metis_comment(const char* p, const char* end) {
+	p = skip_blanks(p, end);
+	return p < end && *p == '%';
+}
+
+// the neighbors of vertex u, after its weights
+template <typename F>
+static bool metis_line(const char* p, const char* end, long u, const MetisHeader& header, const F& edge) {
+	long x;
+	for (int s = 0; s < header.skip; s++) {
+		next_number(p, end, x);
+	}
+	while (next_number(p, end, x)) {
+		if (x > 0 && !valid_id(x - 1)) {
+			return false;
+		}
+		if (x > 0) {
+			edge(u, x - 1);
+		}
+		if (header.edgeweights) {
+			next_number(p, end, x);
+		}
+	}
+	return true;
+}
+
+// the banner on the first line, which must be for a coordinate matrix
+static bool matrix_market_banner(const char* p, const char* end) {
+	std::string banner(p, next_line(p, end));
+	std::transform(banner.begin(), banner.end(), banner.begin(), ::tolower);
+	return banner.compare(0, 14, "%%matrixmarket") == 0 && banner.find("coordinate") != std::string::npos;
+}
+
+// rows cols entries. the columns of a non-square matrix are vertices after
+// the rows
+static bool matrix_market_header(const char* p, const char* end, long& n, long& shift) {
+	long rows, cols, entries;
+	if (!next_number(p, end, rows) || !next_number(p, end, cols) || !next_number(p, end, entries)) {
+		return false;
+	}
+	shift = rows == cols ? 0 : rows;
+	n = shift + cols;
+	return n <= INT_MAX;
+}
+
+template <typename F>
+static bool matrix_market_line(const char* p, const char* end, long shift, const F& edge) {
+	if (skipped_line(p, end, "%")) {
+		return true;
+	}
+
+	long u, v;
+	if (next_number(p, end, u) && next_number(p, end, v) && u > 0 && v > 0) {
+		if (!valid_id(u - 1) || !valid_id(shift + v - 1)) {
+			return false;
+		}
+		edge(u - 1, shift + v - 1);
+	}
+	return true;
+}
+
+// each scanner parses a file in the given number of pieces and returns the
+// number of vertices, or -1 if the header is wrong or an id does not fit in
+// an int
+
+static long scan_snap(TextFile& f, int pieces, int threads, const PieceEdge& edge) {
+	std::vector<const char*> bounds = split_lines(f.data, f.end(), pieces);
+	std::vector<long> top(pieces, 0);
+	parallel_for(pieces, [&](int i) {
+		const char* end = bounds[i + 1];
+		for (const char* p = bounds[i]; p < end; p = next_line(p, end)) {
+			if (!snap_line(p, end, top[i], [&](long u, long v) {edge(i, u, v);})) {
+				top[i] = -1;
+				return;
+			}
+		}
+	}, threads);
+
+	if (std::find(top.begin(), top.end(), -1) != top.end()) {
+		return -1;
+	}
+	return *std::max_element(top.begin(), top.end());
+}
+
+static long scan_dimacs(TextFile& f, int pieces, int threads, const PieceEdge& edge) {
+	std::vector<const char*> bounds = split_lines(f.data, f.end(), pieces);
+	std::vector<long> sizes(pieces, -1);
+	std::vector<char> bad(pieces, 0);
+	parallel_for(pieces, [&](int i) {
+		const char* end = bounds[i + 1];
+		for (const char* p = bounds[i]; p < end; p = next_line(p, end)) {
+			if (!dimacs_line(p, end, sizes[i], [&](long u, long v) {edge(i, u, v);})) {
+				bad[i] = 1;
+				return;
+			}
+		}
+	}, threads);
+
+	long n = *std::max_element(sizes.begin(), sizes.end());
+	if (n > INT_MAX || std::find(bad.begin(), bad.end(), 1) != bad.end()) {
+		return -1;
+	}
+	return n;
+}
+
+static long scan_metis(TextFile& f, int pieces, int threads, const PieceEdge& edge) {
+	const char* end = f.end();
+	const char* p = f.data;
+	while (p < end && skipped_line(p, end, "%")) {
+		p = next_line(p, end);
+	}
+
+	MetisHeader header;
+	if (!metis_header(p, end, header)) {
+		return -1;
+	}
+
+	// vertex i is on the i-th line that is not a comment, so the lines of
+	// each piece are counted before any are parsed
+	std::vector<const char*> bounds = split_lines(next_line(p, end), end, pieces);
+	std::vector<long> first(pieces + 1, 0);
+	parallel_for(pieces, [&](int i) {
+		const char* end = bounds[i + 1];
+		for (const char* p = bounds[i]; p < end; p = next_line(p, end)) {
+			first[i + 1] += !metis_comment(p, end);
+		}
+	}, threads);
+	for (int i = 0; i < pieces; i++) {
+		first[i + 1] += first[i];
+	}
+
+	std::vector<char> bad(pieces, 0);
+	parallel_for(pieces, [&](int i) {
+		const char* end = bounds[i + 1];
+		long u = first[i];
+		for (const char* p = bounds[i]; p < end && u < header.n; p = next_line(p, end)) {
+			if (metis_comment(p, end)) {
+				continue;
+			}
+
+			if (!metis_line(p, end, u, header, [&](long u, long v) {edge(i, u, v);})) {
+				bad[i] = 1;
+				return;
+			}
+			++u;
+		}
+	}, threads);
+
+	if (std::find(bad.begin(), bad.end(), 1) != bad.end()) {
+		return -1;
+	}
+	return header.n;
+}
+
+static long scan_matrix_market(TextFile& f, int pieces, int threads, const PieceEdge& edge) {
+	if (f.length == 0 || !matrix_market_banner(f.data, f.end())) {
+		return -1;
+	}
+
+	const char* end = f.end();
+	const char* p = f.data;
+	while (p < end && skipped_line(p, end, "%")) {
+		p = next_line(p, end);
+	}
+
+	long n, shift;
+	if (!matrix_market_header(p, end, n, shift)) {
+		return -1;
+	}
+
+	std::vector<const char*> bounds = split_lines(next_line(p, end), end, pieces);
+	std::vector<char> bad(pieces, 0);
+	parallel_for(pieces, [&](int i) {
+		const char* end = bounds[i + 1];
+		for (const char* p = bounds[i]; p < end; p = next_line(p, end)) {
+			if (!matrix_market_line(p, end, shift, [&](long u, long v) {edge(i, u, v);})) {
+				bad[i] = 1;
+				return;
+			}
+		}
+	}, threads);
+
+	if (std::find(bad.begin(), bad.end(), 1) != bad.end()) {
+		return -1;
+	}
+	return n;
+}
+
+// parses a file one line at a time in file order, so that a compressed file
+// is read as it is decompressed instead of held in memory
+class LineScanner {
+private:
+	GraphFormat format;
+	const std::function<void(int, int)>& edge;
+	bool started;
+	bool header;
+	bool bad;
+	long n;
+	long u;
+	long shift;
+	MetisHeader metis;
+public:
+	LineScanner(GraphFormat, const std::function<void(int, int)>&);
+
+	bool line(const char*, const char*);
+	long vertices();
+};
+
+// n stays -1 until the header gives it, except in snap files where it
+// follows the largest id
+LineScanner::LineScanner(GraphFormat format, const std::function<void(int, int)>& edge) : format(format), edge(edge), started(false), header(false), bad(false), n(format == FORMAT_SNAP ? 0 : -1), u(0), shift(0) {}
+
+// returns false once the file is known to be wrong
+bool LineScanner::line(const char* p, const char* end) {
+	auto pass = [&](long u, long v) {edge(u, v);};
+	bool first = !started;
+	started = true;
+
+	switch (format) {
+		case FORMAT_METIS:
+			if (header) {
+				if (u < n && !metis_comment(p, end)) {
+					bad = !metis_line(p, end, u++, metis, pass);
+				}
+			}
+			else if (!skipped_line(p, end, "%")) {
+				header = true;
+				bad = !metis_header(p, end, metis);
+				n = bad ? -1 : metis.n;
+			}
+			break;
+		case FORMAT_DIMACS:
+			bad = !dimacs_line(p, end, n, pass);
+			break;
+		case FORMAT_MATRIX_MARKET:
+			if (first) {
+				bad = !matrix_market_banner(p, end);
+			}
+			else if (header) {
+				bad = !matrix_market_line(p, end, shift, pass);
+			}
+			else if (!skipped_line(p, end, "%")) {
+				header = true;
+				bad = !matrix_market_header(p, end, n, shift);
+			}
+			break;
+		default:
+			bad = !snap_line(p, end, n, pass);
+	}
+	return !bad;
+}
+
+// the number of vertices, or -1 as for the scanners
+long LineScanner::vertices() {
+	return bad || n > INT_MAX ? -1 : n;
+}
+
+typedef long (*Scanner)(TextFile&, int, int, const PieceEdge&);
+
+static Scanner scanner(GraphFormat format) {
+	switch (format) {
+		case FORMAT_METIS:
+			return scan_metis;
+		case FORMAT_DIMACS:
+			return scan_dimacs;
+		case FORMAT_MATRIX_MARKET:
+			return scan_matrix_market;
+		default:
+			return scan_snap;
+	}
+}
+
+// parses the edges of the pieces on threads and then inserts them, with the
+// adjacency sets sized beforehand so that none is rehashed
+static Graph* read_with(Scanner scan, const char* filename, int threads) {
+	TextFile f(filename);
+	if (!f.ok) {
+		return NULL;
+	}
+
+	int pieces = 1;
+	if (f.length >= PIECE_MIN) {
+		pieces = 4 * (threads > 0 ? threads : num_threads());
+	}
+
+	std::vector<std::vector<int>> edges(pieces);
+	long n = scan(f, pieces, threads, [&](int piece, int u, int v) {
+		if (u != v) {
+			edges[piece].push_back(u);
+			edges[piece].push_back(v);
+		}
+	});
+	if (n < 0) {
+		return NULL;
+	}
+
+	Map<int> degree;
+	for (auto it = edges.begin(); it != edges.end(); ++it) {
+		for (auto iu = it->begin(); iu != it->end(); ++iu) {
+			++degree[*iu];
+		}
+	}
+
+	Graph* graph = new Graph();
+	graph->adjlist.reserve(degree.size());
+	for (Map<int>::Iterator it = degree.begin(); it != degree.end(); ++it) {
+		graph->adjlist[*it].reserve(it->value);
+	}
+	for (auto it = edges.begin(); it != edges.end(); ++it) {
+		for (size_t i = 0; i < it->size(); i += 2) {
+			graph->add_edge((*it)[i], (*it)[i + 1]);
+		}
+		std::vector<int>().swap(*it);
+	}
+
+	return graph;
+}
+
+Graph* read_metis(const char* filename, int threads) {
+	return read_with(scan_metis, filename, threads);
+}
+
+Graph* read_dimacs(const char* filename, int threads) {
+	return read_with(scan_dimacs, filename, threads);
+}
+
+Graph* read_matrix_market(const char* filename, int threads) {
+	return read_with(scan_matrix_market, filename, threads);
+}
+
+Graph* read_snap(const char* filename, int threads) {
+	return read_with(scan_snap, filename, threads);
+}
+
+Graph* read_graph(const char* filename, int threads) {
+	GraphFormat format = graph_format(filename);
+	if (format == FORMAT_SPARSE6) {
+		return read_sparse6(filename);
+	}
+	return read_with(scanner(format), filename, threads);
+}
+
+int stream_formatted(const char* filename, GraphFormat format, const std::function<void(int, int)>& edge) {
+	if (format == FORMAT_SPARSE6) {
+		return stream_sparse6(filename, edge);
+	}
+
+	if (compressed(filename)) {
+		InputFile f(filename);
+		if (!f.is_open()) {
+			return -1;
+		}
+
+		LineScanner scan(format, edge);
+		std::string line;
+		bool ok = true;
+		while (ok && std::getline(f, line)) {
+			ok = scan.line(line.data(), line.data() + line.size());
+		}
+		return f.bad() ? -1 : scan.vertices();
+	}
+
+	TextFile f(filename);
+	if (!f.ok) {
+		return -1;
+	}
+
+	// one piece on the calling thread keeps the edges in file order
+	return scanner(format)(f, 1, 1, [&](int piece, int u, int v) {
+		edge(u, v);
+	});
+}
+
+static bool has_extension(const std::string& filename, const char* extension) {
+	size_t len = strlen(extension);
+	if (filename.length() < len) {
+		return false;
+	}
+
+	std::string tail = filename.substr(filename.length() - len);
+	std::transform(tail.begin(), tail.end(), tail.begin(), ::tolower);
+	return tail == extension;
+}
+
+GraphFormat graph_format(const char* filename) {
+	std::string name = uncompressed_name(filename);
+	if (has_extension(name, ".s6")) {
+		return FORMAT_SPARSE6;
+	}
+	if (has_extension(name, ".graph") || has_extension(name, ".metis")) {
+		return FORMAT_METIS;
+	}
+	if (has_extension(name, ".dimacs") || has_extension(name, ".col") || has_extension(name, ".clq")) {
+		return FORMAT_DIMACS;
+	}
+	if (has_extension(name, ".mtx")) {
+		return FORMAT_MATRIX_MARKET;
+	}
+	if (has_extension(name, ".snap")) {
+		return FORMAT_SNAP;
+	}
+
+	// otherwise the first line that is not blank decides
+	InputFile f(filename);
+	std::string line;
+	while (std::getline(f, line)) {
+		size_t start = line.find_first_not_of(" \t\r");
+		if (start == std::string::npos) {
+			continue;
+		}
+
+		if (line[start] == ':') {
+			return FORMAT_SPARSE6;
+		}
+		if (line.compare(start, 14, "%%MatrixMarket") == 0) {
+			return FORMAT_MATRIX_MARKET;
+		}
+		if ((line[start] == 'c' || line[start] == 'p') && line.length() > start + 1 && isspace(line[start + 1])) {
+			return FORMAT_DIMACS;
+		}
+		break;
+	}
+	return FORMAT_SNAP;
+}
@@ -0,0 +1,49 @@
+
+#ifndef FORMATS_H
+#define FORMATS_H
+
+#include <functional>
+
+#include "graph.hpp"
+
+enum GraphFormat {
+	FORMAT_SPARSE6,
+	FORMAT_SNAP,
+	FORMAT_METIS,
+	FORMAT_DIMACS,
+	FORMAT_MATRIX_MARKET,
+};
+
+// the format of a file from its extension (.s6, .graph or .metis, .dimacs,
+// .col or .clq, .mtx, .snap, before any .gz or .zst) or else from its first
+// lines. plain edge lists are reported as snap, which only adds comment lines
+// starting with #
+GraphFormat graph_format(const char*);
+
+// readers that map the file and parse pieces of it on threads (as in
+// parallel_for), after decompressing compressed files into memory. ids are
+// made 0-based, self loops are dropped and repeated edges kept once. return
+// NULL if the file cannot be read, has the wrong header or has an id that
+// does not fit in an int.
+//  metis: a header "n m [fmt [ncon]]" and the neighbors of vertex i on line
+//         i, after any vertex weights and with edge weights skipped
+//  dimacs: "p edge n m" and one "e u v" line per edge
+//  matrix market: coordinate matrices, with the columns of a non-square
+//                 matrix numbered after its rows so that it reads as a
+//                 bipartite graph
+//  snap: "u v" lines of 0-based ids, comments starting with # or %
+Graph* read_metis(const char*, int threads = 0);
+Graph* read_dimacs(const char*, int threads = 0);
+Graph* read_matrix_market(const char*, int threads = 0);
+Graph* read_snap(const char*, int threads = 0);
+
+// any of the formats above or sparse6, as found by graph_format
+Graph* read_graph(const char*, int threads = 0);
+
+// calls edge(u, v) for every edge of a file in one of the formats above, in
+// file order and without building a graph, as stream_graph does. compressed
+// files are parsed as they are decompressed rather than in memory. returns
+// the number of vertices, or -1 if the file cannot be read
+int stream_formatted(const char*, GraphFormat, const std::function<void(int, int)>&);
+
+#endif
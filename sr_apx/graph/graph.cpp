@@ -1,9 +1,17 @@
 
 #include "graph.hpp"
 #include "util.hpp"
-
+#include "cancel.hpp"
+#include "parallel.hpp"
+#include "formats.hpp"
+#include "input.hpp"
+#include "csr.hpp"
+
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <fstream>
+#include <vector>
 
 #define BUFFER_SIZE 1024
 
@@ -16,7 +24,10 @@ Graph::~Graph() {
 }
 
 bool Graph::adjacent(int u, int v) {
-    return adjlist[u].contains(v);
+	if (!adjlist.contains(u)) {
+		return false;
+	}
+	return adjlist.find(u)->value.contains(v);
 }
 
 void Graph::add_edge(int u, int v) {
@@ -24,6 +35,14 @@ void Graph::add_edge(int u, int v) {
 	adjlist[v].insert(u);
 }
 
+// the endpoints stay in the graph even if they become isolated
+void Graph::remove_edge(int u, int v) {
+	if (adjacent(u, v)) {
+		adjlist.find(u)->value.erase(v);
+		adjlist.find(v)->value.erase(u);
+	}
+}
+
 int Graph::size() {
 	return adjlist.size();
 }
@@ -40,22 +59,34 @@ Set* Graph::neighbors(int u) {
 	if (!adjlist.contains(u)) {
 		return NULL;
 	}
-	return &(adjlist[u]);
+	return &(adjlist.find(u)->value);
 }
 
 int Graph::degree(int u) {
 	if (!adjlist.contains(u)) {
 		return 0;
 	}
-	return adjlist[u].size();
+	return adjlist.find(u)->value.size();
 }
 
+// returns NULL when the calling thread is cancelled before the copy is done
 Graph* Graph::subgraph(Set* vertices) {
 	Graph* subg = new Graph(vertices->size());
 
+	int steps = 0;
 	for (Set::Iterator iu = vertices->begin(); iu != vertices->end(); ++iu) {
+		if ((++steps & 1023) == 0 && cancelled()) {
+			delete subg;
+			return NULL;
+		}
+
 		int u = *iu;
-		for (Set::Iterator iv = adjlist[u].begin(); iv != adjlist[u].end(); ++iv) {
+		Set* nbrs = neighbors(u);
+		if (nbrs == NULL) {
+			continue;
+		}
+
+		for (Set::Iterator iv = nbrs->begin(); iv != nbrs->end(); ++iv) {
 			int v = *iv;
 			if (vertices->contains(v)) {
 				subg->add_edge(u, v);
@@ -66,14 +97,14 @@ Graph* Graph::subgraph(Set* vertices) {
 	return subg;
 }
 
-Graph* read_sparse6(const char* filename) {
-	std::ifstream f;
-	f.open(filename, std::ios::in | std::ios::binary);
+// reads the header of a sparse6 file, leaving f at the first edge. returns
+// the number of vertices, or -1 if the file is not sparse6
+int sparse6_header(std::istream& f) {
 	char c[7];
 	f.read(c, 1);
 	if (c[0] != ':') {
 		printf("%s\n", "not sparse6");
-		return NULL;
+		return -1;
 	}
 
 	int n;
@@ -99,8 +130,12 @@ Graph* read_sparse6(const char* filename) {
 		}
 	}
 
+	return n;
+}
+
+// decodes the edges following the header of a sparse6 file on n vertices
+void sparse6_edges(std::istream& f, int n, const std::function<void(int, int)>& edge) {
 	int k = log2(n);
-	Graph* graph = new Graph(n);
 
 	int bitbuffer = 0;
 	int bitavailable = 0;
@@ -116,8 +151,15 @@ Graph* read_sparse6(const char* filename) {
 				f.read(buffer, BUFFER_SIZE);
 				available = f.gcount();
 				position = 0;
+				if (available == 0) {
+					return;
+				}
 			}
 
+			// the data ends at a newline or any other byte below 63
+			if (buffer[position] < 63) {
+				return;
+			}
 			bitbuffer = buffer[position++] - 63;
 			bitavailable = 6;
 		}
@@ -130,8 +172,15 @@ Graph* read_sparse6(const char* filename) {
 				f.read(buffer, BUFFER_SIZE);
 				available = f.gcount();
 				position = 0;
+				if (available == 0) {
+					return;
+				}
 			}
 
+			// the data ends at a newline or any other byte below 63
+			if (buffer[position] < 63) {
+				return;
+			}
 			bitbuffer = (bitbuffer << 6) + (buffer[position++] - 63);
 			bitavailable += 6;
 		}
@@ -151,17 +200,50 @@ Graph* read_sparse6(const char* filename) {
 			v = x;
 		}
 		else {
-			graph->add_edge(x, v);
+			edge(x, v);
 		}
 	}
+}
+
+Graph* read_sparse6(const char* filename) {
+	InputFile f(filename);
+	if (!f.is_open()) {
+		return NULL;
+	}
+
+	int n = sparse6_header(f);
+	if (n < 0) {
+		return NULL;
+	}
+
+	Graph* graph = new Graph(n);
+	sparse6_edges(f, n, [graph](int u, int v) {
+		graph->add_edge(u, v);
+	});
+	if (f.bad()) {
+		delete graph;
+		return NULL;
+	}
 
-	f.close();
 	return graph;
 }
 
+int stream_sparse6(const char* filename, const std::function<void(int, int)>& edge) {
+	InputFile f(filename);
+	if (!f.is_open()) {
+		return -1;
+	}
+
+	int n = sparse6_header(f);
+	if (n >= 0) {
+		sparse6_edges(f, n, edge);
+	}
+
+	return f.bad() ? -1 : n;
+}
+
 Graph* read_edge_list(const char* filename) {
-	std::ifstream f;
-	f.open(filename, std::ios::in);
+	InputFile f(filename);
 
 	Graph* g = new Graph();
 
@@ -171,7 +253,320 @@ Graph* read_edge_list(const char* filename) {
 		sscanf(s, "%d %d", &u, &v);
 		g->add_edge(u, v);
 	}
+	if (f.bad()) {
+		delete g;
+		return NULL;
+	}
 
-	f.close();
 	return g;
 }
+
+int stream_graph(const char* filename, const std::function<void(int, int)>& edge) {
+	return stream_formatted(filename, graph_format(filename), edge);
+}
+
+// packs values into 6 bit groups, most significant bit first. the groups are
+// kept without the offset of 63 so that chunks packed apart can be or-ed
+// together where they meet
+struct BitWriter {
+	std::vector<char> out;
+	unsigned long buffer;
+	int used;
+
+	BitWriter(int skip = 0) : buffer(0), used(skip) {};
+
+	void write(int bits, unsigned long value) {
+		buffer = (buffer << bits) | value;
+		used += bits;
+		while (used >= 6) {
+			used -= 6;
+			out.push_back((buffer >> used) & 63);
+		}
+		buffer &= (1UL << used) - 1;
+	}
+
+	// the last group, filled with zero bits
+	void flush() {
+		if (used > 0) {
+			out.push_back((buffer << (6 - used)) & 63);
+			buffer = 0;
+			used = 0;
+		}
+	}
+};
+
+// the number of vertices in the header of sparse6 and graph6
+void write_size(std::ofstream& f, long n) {
+	std::vector<char> size;
+	if (n <= 62) {
+		size.push_back(n + 63);
+	}
+	else {
+		int bits = n <= 258047 ? 18 : 36;
+		size.push_back(126);
+		if (bits == 36) {
+			size.push_back(126);
+		}
+		for (int t = bits - 6; t >= 0; t -= 6) {
+			size.push_back(((n >> t) & 63) + 63);
+		}
+	}
+	f.write(size.data(), size.size());
+}
+
+// one more than the largest label, or -1 if a label is negative
+int label_count(Graph* graph) {
+	int n = 0;
+	for (auto it = graph->begin(); it != graph->end(); ++it) {
+		if (*it < 0) {
+			return -1;
+		}
+		n = std::max(n, *it + 1);
+	}
+	return n;
+}
+
+// vertices [start, end) of a sparse6 encoding, with v the last vertex that
+// had edges before them and skip the bits already used of the first group
+struct Sparse6Chunk {
+	int start;
+	int end;
+	int first;
+	int last;
+	long entries;
+	int v;
+	long offset;
+	BitWriter bits;
+};
+
+// calls entry(b, x) for the sparse6 entries of the edges from y to smaller or
+// equal vertices, updating v, the last vertex with such edges. nbrs(y, f)
+// calls f(x) for the neighbors of y
+template <typename N, typename F>
+void sparse6_vertex(const N& nbrs, int y, int& v, F entry) {
+	bool first = true;
+	nbrs(y, [&](int x) {
+		if (x > y) {
+			return;
+		}
+
+		if (first) {
+			if (y > v + 1) {
+				entry(1, y);
+				entry(0, x);
+			}
+			else {
+				entry(y == v ? 0 : 1, x);
+			}
+			v = y;
+			first = false;
+		}
+		else {
+			entry(0, x);
+		}
+	});
+}
+
+// writes a sparse6 file on vertices [0, n) with the neighbors given by nbrs
+template <typename N>
+bool write_sparse6_with(const N& nbrs, int n, const char* filename, int threads) {
+	std::ofstream f;
+	f.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!f.is_open()) {
+		return false;
+	}
+
+	f.put(':');
+	write_size(f, n);
+	int k = log2(n);
+
+	// the vertices are split in chunks that are counted and then packed in
+	// parallel. a chunk only depends on the last vertex with edges before it
+	// and on how many bits come before it, both known after counting
+	int count = std::max(1, std::min(n / 1024, 8 * (threads > 0 ? threads : num_threads())));
+	std::vector<Sparse6Chunk> chunks(count);
+	for (int c = 0; c < count; c++) {
+		chunks[c].start = (long) n * c / count;
+		chunks[c].end = (long) n * (c + 1) / count;
+	}
+
+	parallel_for(count, [&](int c) {
+		Sparse6Chunk& chunk = chunks[c];
+		chunk.first = -1;
+		chunk.last = -1;
+		chunk.entries = 0;
+		int v = -2;
+		for (int y = chunk.start; y < chunk.end; y++) {
+			sparse6_vertex(nbrs, y, v, [&](int b, int x) {
+				++chunk.entries;
+			});
+			if (v == y && chunk.first < 0) {
+				chunk.first = y;
+			}
+		}
+		chunk.last = chunk.first < 0 ? -1 : v;
+	}, threads);
+
+	int v = 0;
+	long offset = 0;
+	for (auto it = chunks.begin(); it != chunks.end(); ++it) {
+		it->v = v;
+		it->offset = offset;
+		if (it->first < 0) {
+			continue;
+		}
+
+		// counting took the first vertex to need an entry of its own, which
+		// it does not if it follows v
+		if (it->first <= v + 1) {
+			--it->entries;
+		}
+		offset += it->entries * (k + 1);
+		v = it->last;
+	}
+
+	parallel_for(count, [&](int c) {
+		Sparse6Chunk& chunk = chunks[c];
+		chunk.bits = BitWriter(chunk.offset % 6);
+		int v = chunk.v;
+		for (int y = chunk.start; y < chunk.end; y++) {
+			sparse6_vertex(nbrs, y, v, [&](int b, int x) {
+				chunk.bits.write(k + 1, ((unsigned long) b << k) | x);
+			});
+		}
+		chunk.bits.flush();
+	}, threads);
+
+	// a group split between chunks is completed by the next chunk with bits
+	int pending = 0;
+	for (auto it = chunks.begin(); it != chunks.end(); ++it) {
+		std::vector<char>& out = it->bits.out;
+		if (out.empty()) {
+			continue;
+		}
+
+		out[0] |= pending;
+		pending = 0;
+		if ((it->offset + it->entries * (k + 1)) % 6 != 0) {
+			pending = out.back();
+			out.pop_back();
+		}
+		for (auto c = out.begin(); c != out.end(); ++c) {
+			*c += 63;
+		}
+		f.write(out.data(), out.size());
+		std::vector<char>().swap(out);
+	}
+
+	// padding with ones ends the decoding, except that it would add a loop
+	// at vertex n - 1 if that is the next vertex and fits in the padding
+	int pad = (6 - offset % 6) % 6;
+	if (pad > 0) {
+		int ones = (1 << pad) - 1;
+		if (k < 6 && n == (1 << k) && v == n - 2 && pad >= k + 1) {
+			ones >>= 1;
+		}
+		f.put((pending | ones) + 63);
+	}
+	f.put('\n');
+
+	f.close();
+	return !f.fail();
+}
+
+// neighbors of a label in a graph, and in a csr through a dense array from
+// labels to indices so that its vertices can be in any order
+struct GraphNeighbors {
+	Graph* graph;
+
+	template <typename F>
+	void operator()(int y, F f) const {
+		Set* adj = graph->neighbors(y);
+		if (adj != NULL) {
+			for (Set::Iterator it = adj->begin(); it != adj->end(); ++it) {
+				f(*it);
+			}
+		}
+	}
+};
+
+struct CSRNeighbors {
+	CSRGraph* csr;
+	std::vector<int> index;
+
+	template <typename F>
+	void operator()(int y, F f) const {
+		int i = index[y];
+		if (i >= 0) {
+			for (int* it = csr->begin(i); it != csr->end(i); ++it) {
+				f(csr->labels[*it]);
+			}
+		}
+	}
+};
+
+bool write_sparse6(Graph* graph, const char* filename, int threads) {
+	int n = label_count(graph);
+	if (n < 0) {
+		return false;
+	}
+
+	GraphNeighbors nbrs = {graph};
+	return write_sparse6_with(nbrs, n, filename, threads);
+}
+
+bool write_sparse6(CSRGraph* csr, const char* filename, int threads) {
+	int n = 0;
+	for (int i = 0; i < csr->n; i++) {
+		if (csr->labels[i] < 0) {
+			return false;
+		}
+		n = std::max(n, csr->labels[i] + 1);
+	}
+
+	CSRNeighbors nbrs = {csr, std::vector<int>(n, -1)};
+	for (int i = 0; i < csr->n; i++) {
+		nbrs.index[csr->labels[i]] = i;
+	}
+	return write_sparse6_with(nbrs, n, filename, threads);
+}
+
+bool write_graph6(Graph* graph, const char* filename) {
+	int n = label_count(graph);
+	if (n < 0) {
+		return false;
+	}
+
+	std::ofstream f;
+	f.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!f.is_open()) {
+		return false;
+	}
+
+	// the upper triangle of the adjacency matrix, column by column
+	write_size(f, n);
+	BitWriter bits;
+	for (int j = 1; j < n; j++) {
+		Set* nbrs = graph->neighbors(j);
+		for (int i = 0; i < j; i++) {
+			bits.write(1, nbrs != NULL && nbrs->contains(i));
+		}
+
+		if (bits.out.size() >= BUFFER_SIZE) {
+			for (auto c = bits.out.begin(); c != bits.out.end(); ++c) {
+				*c += 63;
+			}
+			f.write(bits.out.data(), bits.out.size());
+			bits.out.clear();
+		}
+	}
+	bits.flush();
+	for (auto c = bits.out.begin(); c != bits.out.end(); ++c) {
+		*c += 63;
+	}
+	f.write(bits.out.data(), bits.out.size());
+	f.put('\n');
+
+	f.close();
+	return !f.fail();
+}
@@ -2,16 +2,23 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
+#include <functional>
+
 #include "setmap.hpp"
 
+class CSRGraph;
+
 class Graph {
 public:
 	Map<Set> adjlist;
 
 	Graph() {};
 	Graph(int);
+	// rebuilds a graph from a csr snapshot, with the original labels
+	Graph(CSRGraph*);
 	~Graph();
 	void add_edge(int, int);
+	void remove_edge(int, int);
 	int size();
 	int degree(int);
 	bool adjacent(int, int);
@@ -23,7 +30,27 @@ public:
 	Graph* subgraph(Set*);
 };
 
+// files ending in .gz or .zst are decompressed while they are read, see
+// input.hpp. this holds for the stream functions and formats.hpp as well.
+// a corrupt or truncated compressed file fails the read (NULL, or -1 from
+// the stream functions) instead of giving part of the graph
 Graph* read_sparse6(const char*);
 Graph* read_edge_list(const char*);
 
+// write a graph keeping its labels, so the file has one vertex more than the
+// largest label and vertices without edges in between. sparse6 is packed in
+// parallel chunks of vertices (threads as in parallel_for), graph6 is the
+// adjacency matrix for small dense graphs. return false if a label is
+// negative or the file cannot be written
+bool write_sparse6(Graph*, const char*, int threads = 0);
+bool write_sparse6(CSRGraph*, const char*, int threads = 0);
+bool write_graph6(Graph*, const char*);
+
+// call edge(u, v) for every edge of a file without building a graph and
+// return the number of vertices, or -1 if the file cannot be read. plain
+// edge lists are streamed by stream_graph as snap files
+int stream_sparse6(const char*, const std::function<void(int, int)>&);
+// any format known to read_graph, see formats.hpp
+int stream_graph(const char*, const std::function<void(int, int)>&);
+
 #endif
@@ -2,14 +2,18 @@
 #include <Python.h>
 
 #include "graph.hpp"
+#include "csr.hpp"
+#include "formats.hpp"
 #include "pyset.hpp"
 #include "pygraph.hpp"
+#include "pycall.hpp"
 
 // graph type /////////////////////////////////////////
 
 static void Graph_dealloc(PyGraph* self) {
 	PyObject_GC_UnTrack(self);
 	delete self->g;
+	delete self->csr;
 	Py_TYPE(self)->tp_free((PyObject*) self);
 }
 
@@ -41,21 +45,33 @@ static int Graph_init(PyGraph* self, PyObject* args) {
 
 static PyObject* Graph_addedge(PyGraph* self, PyObject* args) {
 	int u, v;
-	if (!PyArg_ParseTuple(args, "ii", &u, &v)) {
+	if (!PyArg_ParseTuple(args, "ii", &u, &v) || in_use((PyObject*) self)) {
 		return NULL;
 	}
 
-	self->g->add_edge(u, v);
+	get_graph((PyObject*) self)->add_edge(u, v);
 	Py_RETURN_NONE;
 }
 
+static PyObject* Graph_removeedge(PyGraph* self, PyObject* args) {
+	int u, v;
+	if (!PyArg_ParseTuple(args, "ii", &u, &v) || in_use((PyObject*) self)) {
+		return NULL;
+	}
+
+	get_graph((PyObject*) self)->remove_edge(u, v);
+	Py_RETURN_NONE;
+}
+
+// an attached graph has the same vertices as its csr, so it is not built here
 static PyObject* Graph_size(PyGraph* self) {
-	return PyLong_FromLong(self->g->size());
+	CSRGraph* csr = get_csr((PyObject*) self);
+	return PyLong_FromLong(csr != NULL ? csr->n : self->g->size());
 }
 
 static long Graph_size_len(PyObject* self) {
-	PyGraph* temp = (PyGraph*) self;
-	return temp->g->size();
+	CSRGraph* csr = get_csr(self);
+	return csr != NULL ? csr->n : ((PyGraph*) self)->g->size();
 }
 
 static PyObject* Graph_degree(PyGraph* self, PyObject* args) {
@@ -64,7 +80,7 @@ static PyObject* Graph_degree(PyGraph* self, PyObject* args) {
 		return NULL;
 	}
 
-	return PyLong_FromLong(self->g->degree(u));
+	return PyLong_FromLong(get_graph((PyObject*) self)->degree(u));
 }
 
 static PyObject* Graph_adjacent(PyGraph* self, PyObject* args) {
@@ -73,7 +89,7 @@ static PyObject* Graph_adjacent(PyGraph* self, PyObject* args) {
 		return NULL;
 	}
 
-	if (self->g->adjacent(u, v)) {
+	if (get_graph((PyObject*) self)->adjacent(u, v)) {
 		Py_RETURN_TRUE;
 	}
 	else {
@@ -87,7 +103,7 @@ static PyObject* Graph_contains(PyGraph* self, PyObject* args) {
 		return NULL;
 	}
 
-	if (self->g->adjlist.contains(u)) {
+	if (get_graph((PyObject*) self)->adjlist.contains(u)) {
 		Py_RETURN_TRUE;
 	}
 	else {
@@ -97,7 +113,7 @@ static PyObject* Graph_contains(PyGraph* self, PyObject* args) {
 
 static int Graph_contains_in(PyGraph* self, PyObject* key) {
 	int u = PyLong_AsLong(key);
-	return self->g->adjlist.contains(u);
+	return get_graph((PyObject*) self)->adjlist.contains(u);
 }
 
 static PyObject* Graph_neighbors(PyGraph* self, PyObject* args) {
@@ -106,7 +122,14 @@ static PyObject* Graph_neighbors(PyGraph* self, PyObject* args) {
 		return NULL;
 	}
 
-	return make_PySet(self->g->neighbors(u), true);
+	Set* nbrs = get_graph((PyObject*) self)->neighbors(u);
+	if (nbrs == NULL) {
+		PyErr_Format(PyExc_KeyError, "%d is not a vertex of the graph", u);
+		return NULL;
+	}
+
+	// the set lives in the graph, which it keeps alive
+	return make_PySet(nbrs, true, (PyObject*) self);
 }
 
 static PyObject* Graph_subgraph(PyGraph* self, PyObject* args) {
@@ -116,20 +139,164 @@ static PyObject* Graph_subgraph(PyGraph* self, PyObject* args) {
 	}
 
 	Set* vertices = ((PySet*) s)->s;
-	Graph* subg = self->g->subgraph(vertices);
+	Graph* graph = get_graph((PyObject*) self);
+	Graph* subg;
+	{
+		WithoutGIL nogil({(PyObject*) self, s});
+		subg = graph->subgraph(vertices);
+	}
+	if (subg == NULL) {
+		set_cancelled_error();
+		return NULL;
+	}
 	return make_PyGraph(subg);
 }
 
+// (offsets, nbrs, labels) arrays of the csr snapshot, with the neighbors of
+// vertex labels[i] at nbrs[offsets[i]:offsets[i + 1]] given by index. an
+// attached graph exports its shared memory without copying it
+static PyObject* Graph_tocsr(PyGraph* self) {
+	CSRGraph* csr = get_csr((PyObject*) self);
+	if (csr != NULL) {
+		PyObject* o = (PyObject*) self;
+		return Py_BuildValue("NNN", make_PyIntArray(csr->offsets, csr->n + 1, 'l', o, true),
+			make_PyIntArray(csr->nbrs, csr->m, 'i', o, true), make_PyIntArray(csr->labels, csr->n, 'i', o, true));
+	}
+
+	CSRGraph* snapshot;
+	{
+		WithoutGIL nogil({(PyObject*) self});
+		snapshot = new CSRGraph(self->g);
+	}
+
+	// the arrays move to python, which deletes them
+	PyObject* ret = Py_BuildValue("NNN", make_PyIntArray(snapshot->offsets, snapshot->n + 1, 'l'),
+		make_PyIntArray(snapshot->nbrs, snapshot->m, 'i'), make_PyIntArray(snapshot->labels, snapshot->n, 'i'));
+	snapshot->offsets = NULL;
+	snapshot->nbrs = NULL;
+	snapshot->labels = NULL;
+	delete snapshot;
+	return ret;
+}
+
+// edges given as an (m, 2) array or a flat array of endpoint pairs
+static PyObject* Graph_fromedges(PyObject* cls, PyObject* args) {
+	PyObject* a;
+	if (!PyArg_ParseTuple(args, "O", &a)) {
+		return NULL;
+	}
+
+	Py_buffer view;
+	if (!get_int_buffer(a, &view)) {
+		return NULL;
+	}
+
+	Py_ssize_t count = view.len / view.itemsize;
+	if ((view.ndim == 2 && view.shape[1] != 2) || view.ndim > 2 || count % 2 != 0) {
+		PyBuffer_Release(&view);
+		PyErr_SetString(PyExc_ValueError, "edges must be an (m, 2) array or a flat array of pairs");
+		return NULL;
+	}
+
+	// the degrees are counted first so that no adjacency set is rehashed
+	Graph* graph = new Graph();
+	{
+		WithoutGIL nogil({});
+		Map<int> degree;
+		for (Py_ssize_t i = 0; i < count; i++) {
+			++degree[int_buffer_at(&view, i)];
+		}
+
+		graph->adjlist.reserve(degree.size());
+		for (Map<int>::Iterator it = degree.begin(); it != degree.end(); ++it) {
+			graph->adjlist[*it].reserve(it->value);
+		}
+		for (Py_ssize_t i = 0; i < count; i += 2) {
+			graph->add_edge(int_buffer_at(&view, i), int_buffer_at(&view, i + 1));
+		}
+	}
+	PyBuffer_Release(&view);
+
+	return make_PyGraph(graph);
+}
+
+// pickles the graph as one buffer in the layout of a csr file, which
+// protocol 5 can hand over out of band
+static PyObject* Graph_reduceex(PyGraph* self, PyObject* args) {
+	int protocol;
+	if (!PyArg_ParseTuple(args, "i", &protocol)) {
+		return NULL;
+	}
+
+	// __new__ without __init__ leaves neither graph to pickle
+	if (self->g == NULL && self->csr == NULL) {
+		PyErr_SetString(PyExc_ValueError, "cannot pickle an uninitialized Graph");
+		return NULL;
+	}
+
+	CSRGraph* csr = get_csr((PyObject*) self);
+	CSRGraph* snapshot = NULL;
+	if (csr == NULL) {
+		WithoutGIL nogil({(PyObject*) self});
+		snapshot = new CSRGraph(self->g);
+	}
+
+	PyObject* data = PyBytes_FromStringAndSize(NULL, csr_bytes(csr != NULL ? csr : snapshot));
+	if (data != NULL) {
+		WithoutGIL nogil({(PyObject*) self});
+		pack_csr(csr != NULL ? csr : snapshot, PyBytes_AS_STRING(data));
+	}
+	delete snapshot;
+
+	PyObject* unpickle = PyObject_GetAttrString((PyObject*) Py_TYPE(self), "_unpickle");
+	PyObject* buffer = pickle_buffer(data, protocol);
+	if (unpickle == NULL || buffer == NULL) {
+		Py_XDECREF(unpickle);
+		Py_XDECREF(buffer);
+		return NULL;
+	}
+	return Py_BuildValue("N(N)", unpickle, buffer);
+}
+
+// the unpickled graph holds only the csr, as an attached one does, until a
+// call needs the hash graph
+static PyObject* Graph_unpickle(PyObject* cls, PyObject* args) {
+	Py_buffer view;
+	if (!PyArg_ParseTuple(args, "y*", &view)) {
+		return NULL;
+	}
+
+	CSRGraph* csr;
+	{
+		WithoutGIL nogil({});
+		csr = unpack_csr(view.buf, view.len);
+	}
+	PyBuffer_Release(&view);
+	if (csr == NULL) {
+		PyErr_SetString(PyExc_ValueError, "not a pickled graph");
+		return NULL;
+	}
+
+	PyGraph* ret = (PyGraph*) Graph_new((PyTypeObject*) cls, NULL, NULL);
+	ret->csr = csr;
+	return (PyObject*) ret;
+}
+
 static PyMethodDef Graph_methods[] = {
 	{"contains", (PyCFunction) Graph_contains, METH_VARARGS, "check if a vertex is in the graph"},
 	{"__contains__", (PyCFunction) Graph_contains, METH_VARARGS, "check if a vertex is in the graph"},
 	{"size", (PyCFunction) Graph_size, METH_NOARGS, "gets the number of vertices in the graph"},
 	{"__sizeof__", (PyCFunction) Graph_size, METH_NOARGS, "gets the number of vertices in the graph"},
 	{"add_edge", (PyCFunction) Graph_addedge, METH_VARARGS, "adds an edge to the graph"},
+	{"remove_edge", (PyCFunction) Graph_removeedge, METH_VARARGS, "removes an edge from the graph, keeping its endpoints"},
 	{"degree", (PyCFunction) Graph_degree, METH_VARARGS, "gets the degree of a vertex"},
 	{"adjacent", (PyCFunction) Graph_adjacent, METH_VARARGS, "gets whether two vertices are connected by an edge"},
 	{"neighbors", (PyCFunction) Graph_neighbors, METH_VARARGS, "gets the set of neighbors"},
 	{"subgraph", (PyCFunction) Graph_subgraph, METH_VARARGS, "creates a subgraph containing the specified vertices"},
+	{"to_csr", (PyCFunction) Graph_tocsr, METH_NOARGS, "gets the offsets, neighbor indices and labels of the graph as arrays supporting the buffer protocol"},
+	{"from_edges", (PyCFunction) Graph_fromedges, METH_VARARGS | METH_CLASS, "creates a graph from a buffer of edges, such as an (m, 2) numpy array"},
+	{"__reduce_ex__", (PyCFunction) Graph_reduceex, METH_VARARGS, "pickles the graph as a csr buffer, out of band with protocol 5"},
+	{"_unpickle", (PyCFunction) Graph_unpickle, METH_VARARGS | METH_CLASS, "rebuilds a graph from the buffer written by pickling"},
 	{NULL},
 };
 
@@ -192,7 +359,7 @@ static PyMethodDef GraphIter_methods[] = {
 
 PyTypeObject GraphIter_type = {
 	PyVarObject_HEAD_INIT(NULL, 0)
-	.tp_name = "graph.GraphIterator",
+	.tp_name = "sr_apx.graph.GraphIterator",
 	.tp_basicsize = sizeof(PyGraphIter),
 	.tp_itemsize = 0,
 	.tp_dealloc = (destructor) GraphIter_dealloc,
@@ -212,15 +379,15 @@ static PyObject* Graph_iter(PyGraph* self) {
 
 	Py_INCREF(self);
 	iter->g = self;
-	iter->current = Map<Set>::Iterator(&(self->g->adjlist));
-	iter->len = self->g->size();
+	iter->current = Map<Set>::Iterator(&(get_graph((PyObject*) self)->adjlist));
+	iter->len = get_graph((PyObject*) self)->size();
 	PyObject_GC_Track(iter);
 	return (PyObject*) iter;
 }
 
 static PyTypeObject Graph_type = {
 	PyVarObject_HEAD_INIT(NULL, 0)
-	.tp_name = "graph.Graph",
+	.tp_name = "sr_apx.graph.Graph",
 	.tp_basicsize = sizeof(PyGraph),
 	.tp_itemsize = 0,
 	.tp_dealloc = (destructor) Graph_dealloc,
@@ -246,7 +413,17 @@ static PyObject* graph_read_sparse6(PyObject* self, PyObject* args) {
 	char* s;
 	Py_ssize_t len;
 	PyBytes_AsStringAndSize(bytes, &s, &len);
-	PyObject* g = make_PyGraph(read_sparse6(s));
+	Graph* graph;
+	{
+		WithoutGIL nogil({});
+		graph = read_sparse6(s);
+	}
+	if (graph == NULL) {
+		PyErr_Format(PyExc_OSError, "could not read '%s' as sparse6", s);
+		Py_DECREF(bytes);
+		return NULL;
+	}
+	PyObject* g = make_PyGraph(graph);
 	Py_DECREF(bytes);
 	return g;
 }
@@ -260,14 +437,185 @@ static PyObject* graph_read_edge_list(PyObject* self, PyObject* args) {
 	char* s;
 	Py_ssize_t len;
 	PyBytes_AsStringAndSize(bytes, &s, &len);
-	PyObject* g = make_PyGraph(read_edge_list(s));
+	Graph* graph;
+	{
+		WithoutGIL nogil({});
+		graph = read_edge_list(s);
+	}
+	if (graph == NULL) {
+		PyErr_Format(PyExc_OSError, "could not read '%s' as an edge list", s);
+		Py_DECREF(bytes);
+		return NULL;
+	}
+	PyObject* g = make_PyGraph(graph);
 	Py_DECREF(bytes);
 	return g;
 }
 
+// calls one of the readers of formats.hpp on a path and thread count
+static PyObject* read_formatted(Graph* (*reader)(const char*, int), PyObject* args) {
+	PyObject* bytes;
+	int threads = 0;
+	if (!PyArg_ParseTuple(args, "O&|i", PyUnicode_FSConverter, &bytes, &threads)) {
+		return NULL;
+	}
+
+	const char* s = PyBytes_AS_STRING(bytes);
+	Graph* graph;
+	{
+		WithoutGIL nogil({});
+		graph = reader(s, threads);
+	}
+	if (graph == NULL) {
+		PyErr_Format(PyExc_OSError, "could not read '%s' as a graph", s);
+		Py_DECREF(bytes);
+		return NULL;
+	}
+	Py_DECREF(bytes);
+	return make_PyGraph(graph);
+}
+
+static PyObject* graph_read_graph(PyObject* self, PyObject* args) {
+	return read_formatted(read_graph, args);
+}
+
+static PyObject* graph_read_metis(PyObject* self, PyObject* args) {
+	return read_formatted(read_metis, args);
+}
+
+static PyObject* graph_read_dimacs(PyObject* self, PyObject* args) {
+	return read_formatted(read_dimacs, args);
+}
+
+static PyObject* graph_read_matrix_market(PyObject* self, PyObject* args) {
+	return read_formatted(read_matrix_market, args);
+}
+
+static PyObject* graph_read_snap(PyObject* self, PyObject* args) {
+	return read_formatted(read_snap, args);
+}
+
+static PyObject* graph_write_sparse6(PyObject* self, PyObject* args) {
+	PyObject* g;
+	PyObject* bytes;
+	int threads = 0;
+	if (!PyArg_ParseTuple(args, "O!O&|i", &Graph_type, &g, PyUnicode_FSConverter, &bytes, &threads)) {
+		return NULL;
+	}
+
+	// a graph that is only a csr is written without building it
+	CSRGraph* csr = get_csr(g);
+	Graph* graph = csr == NULL ? get_graph(g) : NULL;
+	const char* s = PyBytes_AS_STRING(bytes);
+	bool written;
+	{
+		WithoutGIL nogil({g});
+		written = csr != NULL ? write_sparse6(csr, s, threads) : write_sparse6(graph, s, threads);
+	}
+	if (!written) {
+		PyErr_Format(PyExc_OSError, "could not write '%s', the file must be writable and the labels nonnegative", s);
+	}
+	Py_DECREF(bytes);
+	if (!written) {
+		return NULL;
+	}
+	Py_RETURN_NONE;
+}
+
+static PyObject* graph_write_graph6(PyObject* self, PyObject* args) {
+	PyObject* g;
+	PyObject* bytes;
+	if (!PyArg_ParseTuple(args, "O!O&", &Graph_type, &g, PyUnicode_FSConverter, &bytes)) {
+		return NULL;
+	}
+
+	Graph* graph = get_graph(g);
+	const char* s = PyBytes_AS_STRING(bytes);
+	bool written;
+	{
+		WithoutGIL nogil({g});
+		written = write_graph6(graph, s);
+	}
+	if (!written) {
+		PyErr_Format(PyExc_OSError, "could not write '%s', the file must be writable and the labels nonnegative", s);
+	}
+	Py_DECREF(bytes);
+	if (!written) {
+		return NULL;
+	}
+	Py_RETURN_NONE;
+}
+
+static PyObject* graph_share_graph(PyObject* self, PyObject* args) {
+	PyObject* g;
+	const char* name;
+	if (!PyArg_ParseTuple(args, "O!s", &Graph_type, &g, &name)) {
+		return NULL;
+	}
+
+	// an attached graph that was never built is shared from its own csr
+	CSRGraph* csr = get_csr(g);
+	Graph* graph = ((PyGraph*) g)->g;
+	bool shared;
+	{
+		WithoutGIL nogil({g});
+		if (csr != NULL) {
+			shared = share_csr(csr, name);
+		}
+		else {
+			CSRGraph snapshot(graph);
+			shared = share_csr(&snapshot, name);
+		}
+	}
+
+	if (!shared) {
+		PyErr_SetFromErrnoWithFilename(PyExc_OSError, name);
+		return NULL;
+	}
+	Py_RETURN_NONE;
+}
+
+static PyObject* graph_attach_graph(PyObject* self, PyObject* args) {
+	const char* name;
+	if (!PyArg_ParseTuple(args, "s", &name)) {
+		return NULL;
+	}
+
+	CSRGraph* csr = attach_csr(name);
+	if (csr == NULL) {
+		PyErr_Format(PyExc_OSError, "no shared graph named '%s'", name);
+		return NULL;
+	}
+
+	return make_PyGraph(csr);
+}
+
+static PyObject* graph_unshare_graph(PyObject* self, PyObject* args) {
+	const char* name;
+	if (!PyArg_ParseTuple(args, "s", &name)) {
+		return NULL;
+	}
+
+	if (!unshare_csr(name)) {
+		PyErr_SetFromErrnoWithFilename(PyExc_OSError, name);
+		return NULL;
+	}
+	Py_RETURN_NONE;
+}
+
 static PyMethodDef graph_module_methods[] = {
 	{"read_sparse6", graph_read_sparse6, METH_VARARGS, "reads a graph from file formatted as sparse6"},
 	{"read_edge_list", graph_read_edge_list, METH_VARARGS, "reads a graph from file formatted as an edge list"},
+	{"read_graph", graph_read_graph, METH_VARARGS, "reads a graph in any known format, found from the extension or the first line"},
+	{"read_metis", graph_read_metis, METH_VARARGS, "reads a graph from a METIS file, parsing pieces of it in parallel"},
+	{"read_dimacs", graph_read_dimacs, METH_VARARGS, "reads a graph from a DIMACS edge file, parsing pieces of it in parallel"},
+	{"read_matrix_market", graph_read_matrix_market, METH_VARARGS, "reads a graph from a MatrixMarket coordinate file, parsing pieces of it in parallel"},
+	{"read_snap", graph_read_snap, METH_VARARGS, "reads a graph from a SNAP edge list, parsing pieces of it in parallel"},
+	{"write_sparse6", graph_write_sparse6, METH_VARARGS, "writes a graph to a sparse6 file, encoding chunks of vertices in parallel"},
+	{"write_graph6", graph_write_graph6, METH_VARARGS, "writes a graph to a graph6 file, for small dense graphs"},
+	{"share_graph", graph_share_graph, METH_VARARGS, "copies a graph into shared memory under a name such as '/graph', for other processes to attach to"},
+	{"attach_graph", graph_attach_graph, METH_VARARGS, "attaches read-only to a graph shared under the given name"},
+	{"unshare_graph", graph_unshare_graph, METH_VARARGS, "removes the name of a shared graph, attached graphs stay valid"},
 	{NULL},
 };
 
@@ -315,3 +663,9 @@ PyObject* make_PyGraph(Graph* base) {
 	ret->g = base;
 	return (PyObject*) ret;
 }
+
+PyObject* make_PyGraph(CSRGraph* csr) {
+	PyGraph* ret = (PyGraph*) Graph_new(&Graph_type, NULL, NULL);
+	ret->csr = csr;
+	return (PyObject*) ret;
+}
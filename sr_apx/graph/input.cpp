@@ -0,0 +1,266 @@
+#include "input.hpp"
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <ios>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+// the decompressing thread works in blocks of this size and stops when this
+// many are waiting to be parsed
+#define BLOCK_SIZE (1 << 20)
+#define BLOCKS_AHEAD 4
+
+static bool has_suffix(const std::string& name, const char* suffix) {
+	size_t len = strlen(suffix);
+	return name.length() > len && name.compare(name.length() - len, len, suffix) == 0;
+}
+
+bool compressed(const char* filename) {
+	std::string name(filename);
+	return has_suffix(name, ".gz") || has_suffix(name, ".zst");
+}
+
+std::string uncompressed_name(const char* filename) {
+	std::string name(filename);
+	if (has_suffix(name, ".gz")) {
+		return name.substr(0, name.length() - 3);
+	}
+	if (has_suffix(name, ".zst")) {
+		return name.substr(0, name.length() - 4);
+	}
+	return name;
+}
+
+// fills out with up to size decompressed bytes. returns the number written,
+// 0 at the end of the data and -1 if it is corrupt or ends early
+class Decoder {
+public:
+	virtual ~Decoder() {};
+	virtual int read(char* out, int size) = 0;
+};
+
+#ifdef HAVE_ZLIB
+class GzipDecoder : public Decoder {
+public:
+	gzFile f;
+
+	GzipDecoder(gzFile f) : f(f) {};
+	~GzipDecoder() {gzclose(f);};
+
+	// a truncated file reads short and then ends with Z_BUF_ERROR set
+	int read(char* out, int size) {
+		int count = gzread(f, out, size);
+		int error = Z_OK;
+		if (count == 0) {
+			gzerror(f, &error);
+		}
+		return error == Z_OK ? count : -1;
+	}
+};
+#endif
+
+#ifdef HAVE_ZSTD
+class ZstdDecoder : public Decoder {
+public:
+	FILE* f;
+	ZSTD_DCtx* context;
+	std::vector<char> in;
+	ZSTD_inBuffer input;
+	bool eof;
+	size_t pending;
+
+	ZstdDecoder(FILE* f) : f(f), context(ZSTD_createDCtx()), in(ZSTD_DStreamInSize()), eof(false), pending(0) {
+		input.src = in.data();
+		input.size = 0;
+		input.pos = 0;
+	};
+
+	~ZstdDecoder() {
+		ZSTD_freeDCtx(context);
+		fclose(f);
+	};
+
+	// pending is what the last call that did any work returned, nonzero while
+	// a frame is unfinished, so a file that ends in the middle of one is an
+	// error. calls that do nothing report the header of a next frame instead
+	int read(char* out, int size) {
+		ZSTD_outBuffer output = {out, (size_t) size, 0};
+		while (output.pos < output.size) {
+			if (input.pos == input.size && !eof) {
+				input.size = fread(in.data(), 1, in.size(), f);
+				input.pos = 0;
+				eof = input.size == 0;
+			}
+
+			// with the input used up, calls go on while they still flush
+			size_t before = output.pos;
+			size_t consumed = input.pos;
+			size_t ret = ZSTD_decompressStream(context, &output, &input);
+			if (ZSTD_isError(ret)) {
+				return -1;
+			}
+			if (output.pos != before || input.pos != consumed) {
+				pending = ret;
+			}
+			if (eof && output.pos == before) {
+				if (pending != 0 || ferror(f)) {
+					return -1;
+				}
+				break;
+			}
+		}
+		return output.pos;
+	}
+};
+#endif
+
+// a stream buffer fed by a thread that runs a decoder, handing blocks over
+// through a short queue. when the decoder fails, underflow throws once the
+// blocks before the failure are read, which sets badbit on the stream
+class PipeBuffer : public std::streambuf {
+public:
+	PipeBuffer(Decoder*);
+	~PipeBuffer();
+
+protected:
+	int_type underflow();
+
+private:
+	Decoder* decoder;
+	std::thread worker;
+	std::mutex lock;
+	std::condition_variable wake;
+	std::deque<std::vector<char>> blocks;
+	std::vector<char> current;
+	bool done;
+	bool failed;
+	bool stopping;
+
+	void fill();
+};
+
+PipeBuffer::PipeBuffer(Decoder* decoder) : decoder(decoder), done(false), failed(false), stopping(false) {
+	worker = std::thread(&PipeBuffer::fill, this);
+}
+
+PipeBuffer::~PipeBuffer() {
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		stopping = true;
+	}
+	wake.notify_all();
+	worker.join();
+	delete decoder;
+}
+
+void PipeBuffer::fill() {
+	while (true) {
+		std::vector<char> block(BLOCK_SIZE);
+		int count = decoder->read(block.data(), BLOCK_SIZE);
+
+		std::unique_lock<std::mutex> guard(lock);
+		wake.wait(guard, [this] {return blocks.size() < BLOCKS_AHEAD || stopping;});
+		if (stopping) {
+			return;
+		}
+
+		if (count <= 0) {
+			done = true;
+			failed = count < 0;
+			wake.notify_all();
+			return;
+		}
+
+		block.resize(count);
+		blocks.push_back(std::move(block));
+		wake.notify_all();
+	}
+}
+
+PipeBuffer::int_type PipeBuffer::underflow() {
+	if (gptr() < egptr()) {
+		return traits_type::to_int_type(*gptr());
+	}
+
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		wake.wait(guard, [this] {return !blocks.empty() || done;});
+		if (blocks.empty() && failed) {
+			throw std::ios_base::failure("corrupt or truncated compressed file");
+		}
+		if (blocks.empty()) {
+			return traits_type::eof();
+		}
+
+		current.swap(blocks.front());
+		blocks.pop_front();
+	}
+	wake.notify_all();
+
+	setg(current.data(), current.data(), current.data() + current.size());
+	return traits_type::to_int_type(*gptr());
+}
+
+static Decoder* open_decoder(const std::string& name) {
+#ifdef HAVE_ZLIB
+	if (has_suffix(name, ".gz")) {
+		gzFile f = gzopen(name.c_str(), "rb");
+		if (f == NULL) {
+			return NULL;
+		}
+		gzbuffer(f, 1 << 17);
+		return new GzipDecoder(f);
+	}
+#endif
+
+#ifdef HAVE_ZSTD
+	if (has_suffix(name, ".zst")) {
+		FILE* f = fopen(name.c_str(), "rb");
+		if (f == NULL) {
+			return NULL;
+		}
+		return new ZstdDecoder(f);
+	}
+#endif
+
+	return NULL;
+}
+
+InputFile::InputFile(const char* filename) : std::istream(NULL), buffer(NULL), open(false) {
+	if (compressed(filename)) {
+		Decoder* decoder = open_decoder(filename);
+		if (decoder != NULL) {
+			buffer = new PipeBuffer(decoder);
+			open = true;
+		}
+	}
+	else {
+		std::filebuf* f = new std::filebuf();
+		open = f->open(filename, std::ios::in | std::ios::binary) != NULL;
+		buffer = f;
+	}
+
+	// a null buffer leaves the stream bad, so reads fail at once
+	rdbuf(buffer);
+}
+
+InputFile::~InputFile() {
+	delete buffer;
+}
+
+bool InputFile::is_open() {
+	return open;
+}
@@ -0,0 +1,32 @@
+
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <istream>
+#include <streambuf>
+#include <string>
+
+// true for names ending in .gz or .zst, which InputFile decompresses
+bool compressed(const char*);
+
+// the name without a trailing .gz or .zst
+std::string uncompressed_name(const char*);
+
+// a binary input stream over a file. .gz files (with zlib) and .zst files
+// (with zstd) are decompressed by a pipeline thread that stays a few blocks
+// ahead of the reader, so decompression overlaps with parsing. is_open() is
+// false if the file cannot be opened or the library was not built in, and
+// bad() is true after a compressed file turns out corrupt or truncated
+class InputFile : public std::istream {
+public:
+	InputFile(const char*);
+	~InputFile();
+
+	bool is_open();
+
+private:
+	std::streambuf* buffer;
+	bool open;
+};
+
+#endif
@@ -4,12 +4,34 @@
 
 #include <Python.h>
 #include "graph.hpp"
+#include "csr.hpp"
 
+// a graph attached to shared memory starts out as only the csr, and gets its
+// own hash graph the first time an algorithm without a csr version needs it.
+// readers starts the struct as in PyReadable
 typedef struct {
 	PyObject_HEAD
+	int readers;
 	Graph* g;
+	CSRGraph* csr;
 } PyGraph;
 
 PyObject* make_PyGraph(Graph*);
+// a graph that is only the csr until a call needs the hash graph
+PyObject* make_PyGraph(CSRGraph*);
+
+static inline Graph* get_graph(PyObject* o) {
+	PyGraph* self = (PyGraph*) o;
+	if (self->g == NULL && self->csr != NULL) {
+		self->g = new Graph(self->csr);
+	}
+	return self->g;
+}
+
+// the shared csr while the graph has not been built, NULL otherwise
+static inline CSRGraph* get_csr(PyObject* o) {
+	PyGraph* self = (PyGraph*) o;
+	return self->g == NULL ? self->csr : NULL;
+}
 
 #endif
@@ -0,0 +1,49 @@
+
+import asyncio
+import atexit
+
+from .lib_jobs import Job, submit, shutdown, threads, pending
+
+# the pool threads must be stopped while the interpreter can still run them
+atexit.register(shutdown)
+
+def _transfer(job, future):
+    if future.done():
+        return
+
+    if job.cancelled():
+        future.cancel()
+        return
+
+    error = job.exception()
+    if error is not None:
+        future.set_exception(error)
+    else:
+        future.set_result(job.result())
+
+# a job may finish after the loop awaiting it has been closed, when nothing
+# is left to tell
+def _notify(loop, job, future):
+    if loop.is_closed():
+        return
+
+    try:
+        loop.call_soon_threadsafe(_transfer, job, future)
+    except RuntimeError:
+        # closed since the check
+        pass
+
+# awaits f(*args, **kwargs) run on the native job pool. cancelling the task,
+# for example through asyncio.wait_for, cancels the job, and the native
+# solvers stop at their next checkpoint
+async def run(f, *args, **kwargs):
+    loop = asyncio.get_running_loop()
+    future = loop.create_future()
+    job = submit(f, *args, **kwargs)
+    job.add_done_callback(lambda j: _notify(loop, j, future))
+
+    try:
+        return await future
+    except asyncio.CancelledError:
+        job.cancel()
+        raise
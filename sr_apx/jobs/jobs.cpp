@@ -0,0 +1,81 @@
+
+#include "jobs.hpp"
+#include "cancel.hpp"
+#include "parallel.hpp"
+
+JobPool::JobPool(int threads) {
+	closing = false;
+	if (threads <= 0) {
+		threads = num_threads();
+	}
+
+	for (int t = 0; t < threads; t++) {
+		workers.push_back(std::thread(&JobPool::work, this));
+	}
+}
+
+JobPool::~JobPool() {
+	shutdown();
+}
+
+void JobPool::work() {
+	while (true) {
+		std::shared_ptr<Job> job;
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			wake.wait(guard, [this]() {return closing || !queue.empty();});
+			if (queue.empty()) {
+				return;
+			}
+
+			job = queue.front();
+			queue.pop_front();
+			running.push_back(job);
+		}
+
+		{
+			CancelScope scope(&job->stop);
+			job->run();
+		}
+
+		std::lock_guard<std::mutex> guard(lock);
+		running.erase(std::find(running.begin(), running.end(), job));
+	}
+}
+
+void JobPool::submit(std::shared_ptr<Job> job) {
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		queue.push_back(job);
+	}
+	wake.notify_one();
+}
+
+int JobPool::pending() {
+	std::lock_guard<std::mutex> guard(lock);
+	return queue.size();
+}
+
+// queued jobs are still run, cancelled, so that they can clean up without
+// doing their work
+void JobPool::shutdown() {
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (closing) {
+			return;
+		}
+
+		closing = true;
+		for (auto it = queue.begin(); it != queue.end(); ++it) {
+			(*it)->cancel();
+		}
+		for (auto it = running.begin(); it != running.end(); ++it) {
+			(*it)->cancel();
+		}
+	}
+	wake.notify_all();
+
+	for (auto it = workers.begin(); it != workers.end(); ++it) {
+		it->join();
+	}
+}
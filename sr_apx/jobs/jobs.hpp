@@ -0,0 +1,53 @@
+
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// work for a JobPool. run is called once on a pool thread with cancelled()
+// reporting stop, also if the job was cancelled before it started, so that it
+// can always release what it holds
+class Job {
+public:
+	std::atomic<bool> stop;
+	std::function<void()> run;
+
+	Job(const std::function<void()>& r) : stop(false), run(r) {};
+
+	// running code sees cancelled() at its next checkpoint and returns NULL
+	void cancel() {stop = true;};
+};
+
+// fixed set of threads taking jobs in submission order
+class JobPool {
+private:
+	std::mutex lock;
+	std::condition_variable wake;
+	std::deque<std::shared_ptr<Job> > queue;
+	std::vector<std::shared_ptr<Job> > running;
+	std::vector<std::thread> workers;
+	bool closing;
+
+	void work();
+public:
+	JobPool(int threads = 0);
+	~JobPool();
+
+	void submit(std::shared_ptr<Job>);
+	int pending();
+	int size() {return workers.size();};
+
+	// cancels the queued and running jobs, runs what is left and joins the
+	// threads. submit must not be called afterwards
+	void shutdown();
+};
+
+#endif
@@ -0,0 +1,354 @@
+#include <Python.h>
+
+#include "jobs.hpp"
+#include "pycall.hpp"
+
+#define JOB_PENDING 0
+#define JOB_RUNNING 1
+#define JOB_FINISHED 2
+#define JOB_CANCELLED 3
+
+// pool shared by all jobs, started by the first submit
+static JobPool* pool = NULL;
+static bool closed = false;
+
+// lets threads without the gil wait for a job
+struct JobSync {
+	std::mutex lock;
+	std::condition_variable finished;
+	bool done;
+
+	JobSync() : done(false) {};
+};
+
+// job type ///////////////////////////////////
+
+// a call of a python function on the pool. state and the python fields are
+// only touched with the gil held
+typedef struct {
+	PyObject_HEAD
+	std::shared_ptr<Job>* job;
+	JobSync* sync;
+	int state;
+	PyObject* func;
+	PyObject* args;
+	PyObject* kwargs;
+	PyObject* result;
+	PyObject* error;
+	PyObject* callbacks;
+} PyJob;
+
+static void Job_dealloc(PyJob* self) {
+	delete self->job;
+	delete self->sync;
+	Py_XDECREF(self->func);
+	Py_XDECREF(self->args);
+	Py_XDECREF(self->kwargs);
+	Py_XDECREF(self->result);
+	Py_XDECREF(self->error);
+	Py_XDECREF(self->callbacks);
+	Py_TYPE(self)->tp_free((PyObject*) self);
+}
+
+// wakes the waiting threads and calls the done callbacks, once per job
+static void job_finish(PyJob* self) {
+	{
+		std::lock_guard<std::mutex> guard(self->sync->lock);
+		self->sync->done = true;
+	}
+	self->sync->finished.notify_all();
+
+	PyObject* callbacks = self->callbacks;
+	self->callbacks = NULL;
+	for (Py_ssize_t i = 0; i < PyList_GET_SIZE(callbacks); i++) {
+		PyObject* f = PyList_GET_ITEM(callbacks, i);
+		PyObject* ret = PyObject_CallFunctionObjArgs(f, (PyObject*) self, NULL);
+		if (ret == NULL) {
+			PyErr_WriteUnraisable(f);
+		}
+		Py_XDECREF(ret);
+	}
+	Py_DECREF(callbacks);
+}
+
+// body of the native job, on a pool thread. the job was given a reference to
+// self when submitted, which is dropped here. a job stopped before it
+// started, as shutdown does with the queue, is cancelled without running
+static void job_run(PyJob* self) {
+	PyGILState_STATE gil = PyGILState_Ensure();
+
+	if (self->state == JOB_PENDING && (*self->job)->stop) {
+		self->state = JOB_CANCELLED;
+		job_finish(self);
+	}
+	else if (self->state == JOB_PENDING) {
+		self->state = JOB_RUNNING;
+		PyObject* ret = PyObject_Call(self->func, self->args, self->kwargs);
+		if (ret != NULL) {
+			self->result = ret;
+			self->state = JOB_FINISHED;
+		}
+		else if ((*self->job)->stop) {
+			PyErr_Clear();
+			self->state = JOB_CANCELLED;
+		}
+		else {
+			PyObject* type;
+			PyObject* value;
+			PyObject* traceback;
+			PyErr_Fetch(&type, &value, &traceback);
+			PyErr_NormalizeException(&type, &value, &traceback);
+			if (traceback != NULL) {
+				PyException_SetTraceback(value, traceback);
+			}
+			self->error = value;
+			Py_XDECREF(type);
+			Py_XDECREF(traceback);
+			self->state = JOB_FINISHED;
+		}
+		job_finish(self);
+	}
+
+	Py_CLEAR(self->func);
+	Py_CLEAR(self->args);
+	Py_CLEAR(self->kwargs);
+	Py_DECREF(self);
+	PyGILState_Release(gil);
+}
+
+// a pending job is dropped at once. a running one is asked to stop, which
+// the solvers notice at their next checkpoint. returns false if the job has
+// already finished
+static PyObject* Job_cancel(PyJob* self) {
+	if (self->state == JOB_FINISHED || self->state == JOB_CANCELLED) {
+		Py_RETURN_FALSE;
+	}
+
+	(*self->job)->cancel();
+	if (self->state == JOB_PENDING) {
+		self->state = JOB_CANCELLED;
+		job_finish(self);
+	}
+	Py_RETURN_TRUE;
+}
+
+static PyObject* Job_cancelled(PyJob* self) {
+	return PyBool_FromLong(self->state == JOB_CANCELLED);
+}
+
+static PyObject* Job_running(PyJob* self) {
+	return PyBool_FromLong(self->state == JOB_RUNNING);
+}
+
+static PyObject* Job_done(PyJob* self) {
+	return PyBool_FromLong(self->state == JOB_FINISHED || self->state == JOB_CANCELLED);
+}
+
+// waits without the gil, returning false with TimeoutError set on timeout
+static bool job_wait(PyJob* self, PyObject* timeout) {
+	double seconds = -1;
+	if (timeout != Py_None) {
+		seconds = PyFloat_AsDouble(timeout);
+		if (PyErr_Occurred()) {
+			return false;
+		}
+	}
+
+	bool done;
+	JobSync* sync = self->sync;
+	Py_BEGIN_ALLOW_THREADS
+	std::unique_lock<std::mutex> guard(sync->lock);
+	if (seconds < 0) {
+		sync->finished.wait(guard, [sync]() {return sync->done;});
+	}
+	else {
+		sync->finished.wait_for(guard, std::chrono::duration<double>(seconds), [sync]() {return sync->done;});
+	}
+	done = sync->done;
+	Py_END_ALLOW_THREADS
+
+	if (!done) {
+		PyErr_SetString(PyExc_TimeoutError, "job did not finish in time");
+	}
+	return done;
+}
+
+static PyObject* Job_result(PyJob* self, PyObject* args, PyObject* kwargs) {
+	static const char* keywords[] = {"timeout", NULL};
+	PyObject* timeout = Py_None;
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O", (char**) keywords, &timeout) || !job_wait(self, timeout)) {
+		return NULL;
+	}
+
+	if (self->state == JOB_CANCELLED) {
+		set_cancelled_error();
+		return NULL;
+	}
+	if (self->error != NULL) {
+		PyErr_SetObject((PyObject*) Py_TYPE(self->error), self->error);
+		return NULL;
+	}
+
+	Py_INCREF(self->result);
+	return self->result;
+}
+
+static PyObject* Job_exception(PyJob* self, PyObject* args, PyObject* kwargs) {
+	static const char* keywords[] = {"timeout", NULL};
+	PyObject* timeout = Py_None;
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O", (char**) keywords, &timeout) || !job_wait(self, timeout)) {
+		return NULL;
+	}
+
+	if (self->state == JOB_CANCELLED) {
+		set_cancelled_error();
+		return NULL;
+	}
+	if (self->error == NULL) {
+		Py_RETURN_NONE;
+	}
+
+	Py_INCREF(self->error);
+	return self->error;
+}
+
+// f(job) is called once the job is done, on the pool thread that ran it or
+// the thread that cancelled it, or right away if it is done already
+static PyObject* Job_adddonecallback(PyJob* self, PyObject* args) {
+	PyObject* f;
+	if (!PyArg_ParseTuple(args, "O", &f)) {
+		return NULL;
+	}
+
+	if (self->callbacks != NULL) {
+		if (PyList_Append(self->callbacks, f) < 0) {
+			return NULL;
+		}
+		Py_RETURN_NONE;
+	}
+
+	PyObject* ret = PyObject_CallFunctionObjArgs(f, (PyObject*) self, NULL);
+	if (ret == NULL) {
+		return NULL;
+	}
+	Py_DECREF(ret);
+	Py_RETURN_NONE;
+}
+
+static PyMethodDef Job_methods[] = {
+	{"cancel", (PyCFunction) Job_cancel, METH_NOARGS, "drops a pending job or stops a running one at its next checkpoint, false if it is already done"},
+	{"cancelled", (PyCFunction) Job_cancelled, METH_NOARGS, "checks if the job was cancelled"},
+	{"running", (PyCFunction) Job_running, METH_NOARGS, "checks if the job is running"},
+	{"done", (PyCFunction) Job_done, METH_NOARGS, "checks if the job finished or was cancelled"},
+	{"result", (PyCFunction) Job_result, METH_VARARGS | METH_KEYWORDS, "waits for the result, raising the job's exception, CancelledError or TimeoutError"},
+	{"exception", (PyCFunction) Job_exception, METH_VARARGS | METH_KEYWORDS, "waits for the job and returns the exception it raised, or None"},
+	{"add_done_callback", (PyCFunction) Job_adddonecallback, METH_VARARGS, "calls a function with the job once it is done"},
+	{NULL},
+};
+
+static PyTypeObject Job_type = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "jobs.Job",
+	.tp_basicsize = sizeof(PyJob),
+	.tp_itemsize = 0,
+	.tp_dealloc = (destructor) Job_dealloc,
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_doc = "call running on the native job pool, with the interface of concurrent.futures.Future",
+	.tp_methods = Job_methods,
+};
+
+// module //////////////////////////////////////
+
+static PyObject* jobs_submit(PyObject* self, PyObject* args, PyObject* kwargs) {
+	if (PyTuple_GET_SIZE(args) < 1) {
+		PyErr_SetString(PyExc_TypeError, "submit needs a function to call");
+		return NULL;
+	}
+	if (closed) {
+		PyErr_SetString(PyExc_RuntimeError, "the job pool has been shut down");
+		return NULL;
+	}
+
+	PyJob* job = PyObject_New(PyJob, &Job_type);
+	if (job == NULL) {
+		return NULL;
+	}
+
+	job->state = JOB_PENDING;
+	job->func = PyTuple_GET_ITEM(args, 0);
+	Py_INCREF(job->func);
+	job->args = PyTuple_GetSlice(args, 1, PyTuple_GET_SIZE(args));
+	job->kwargs = kwargs;
+	Py_XINCREF(kwargs);
+	job->result = NULL;
+	job->error = NULL;
+	job->callbacks = PyList_New(0);
+	job->sync = new JobSync();
+	job->job = new std::shared_ptr<Job>(new Job([job]() {job_run(job);}));
+
+	if (pool == NULL) {
+		pool = new JobPool();
+	}
+
+	// the reference for job_run
+	Py_INCREF(job);
+	pool->submit(*job->job);
+	return (PyObject*) job;
+}
+
+static PyObject* jobs_shutdown(PyObject* self) {
+	if (pool != NULL) {
+		// the pool threads need the gil to finish their jobs
+		JobPool* p = pool;
+		Py_BEGIN_ALLOW_THREADS
+		delete p;
+		Py_END_ALLOW_THREADS
+		pool = NULL;
+	}
+	closed = true;
+	Py_RETURN_NONE;
+}
+
+static PyObject* jobs_threads(PyObject* self) {
+	return PyLong_FromLong(pool != NULL ? pool->size() : 0);
+}
+
+static PyObject* jobs_pending(PyObject* self) {
+	return PyLong_FromLong(pool != NULL ? pool->pending() : 0);
+}
+
+static PyMethodDef jobs_methods[] = {
+	{"submit", (PyCFunction) jobs_submit, METH_VARARGS | METH_KEYWORDS, "runs f(*args, **kwargs) on the native thread pool and returns its Job"},
+	{"shutdown", (PyCFunction) jobs_shutdown, METH_NOARGS, "cancels all jobs and stops the pool threads"},
+	{"threads", (PyCFunction) jobs_threads, METH_NOARGS, "gets the number of pool threads, 0 before the first submit"},
+	{"pending", (PyCFunction) jobs_pending, METH_NOARGS, "gets the number of jobs waiting for a thread"},
+	{NULL},
+};
+
+static struct PyModuleDef jobs_module = {
+	PyModuleDef_HEAD_INIT,
+	"jobs",
+	"Python interface for the native job pool",
+	-1,
+	jobs_methods
+};
+
+PyMODINIT_FUNC PyInit_lib_jobs() {
+	if (PyType_Ready(&Job_type) < 0) {
+		return NULL;
+	}
+
+	PyObject* m = PyModule_Create(&jobs_module);
+	if (m == NULL) {
+		return NULL;
+	}
+
+	Py_INCREF(&Job_type);
+	if (PyModule_AddObject(m, "Job", (PyObject*) &Job_type) < 0) {
+		Py_DECREF(&Job_type);
+		Py_DECREF(m);
+		return NULL;
+	}
+
+	return m;
+}
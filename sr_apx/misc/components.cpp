@@ -0,0 +1,38 @@
+
+#include "components.hpp"
+
+std::vector<Set*> connected_components(Graph* graph) {
+	std::vector<Set*> components;
+	Set visited;
+	std::vector<int> stack;
+
+	for (auto iu = graph->begin(); iu != graph->end(); ++iu) {
+		int u = *iu;
+		if (visited.contains(u)) {
+			continue;
+		}
+
+		Set* component = new Set();
+		visited.insert(u);
+		stack.push_back(u);
+
+		while (!stack.empty()) {
+			int current = stack.back();
+			stack.pop_back();
+			component->insert(current);
+
+			Set* nbrs = graph->neighbors(current);
+			for (Set::Iterator iv = nbrs->begin(); iv != nbrs->end(); ++iv) {
+				int v = *iv;
+				if (!visited.contains(v)) {
+					visited.insert(v);
+					stack.push_back(v);
+				}
+			}
+		}
+
+		components.push_back(component);
+	}
+
+	return components;
+}
@@ -0,0 +1,12 @@
+
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include <vector>
+
+#include "setmap.hpp"
+#include "graph.hpp"
+
+std::vector<Set*> connected_components(Graph*);
+
+#endif
@@ -1,16 +1,40 @@
 
 #include "matching.hpp"
+#include "bipartite.hpp"
+#include "cancel.hpp"
 
 #include <vector>
 #include <deque>
 
-Map<int>* bipartite_matching(Graph* graph, Set* left, Set* right) {
+// hopcroft-karp between left and right. pairs of initial that are still edges
+// between the two sides seed the matching, so only the change is augmented
+Map<int>* bipartite_matching(Graph* graph, Set* left, Set* right, Map<int>* initial) {
 	Map<int>* match = new Map<int>();
 
+	if (initial != NULL) {
+		for (Map<int>::Iterator it = initial->begin(); it != initial->end(); ++it) {
+			int u = *it;
+			int v = it->value;
+			if (!left->contains(u) || !right->contains(v) || match->contains(u) || match->contains(v)) {
+				continue;
+			}
+
+			if (graph->adjacent(u, v)) {
+				(*match)[u] = v;
+				(*match)[v] = u;
+			}
+		}
+	}
+
 	bool update = true;
+	int steps = 0;
 
 	while (update) {
 		update = false;
+		if (cancelled()) {
+			delete match;
+			return NULL;
+		}
 
 		std::deque<int> queue;
 		Map<int> distance;
@@ -46,6 +70,11 @@ Map<int>* bipartite_matching(Graph* graph, Set* left, Set* right) {
 		Map<int> parent;
 
 		while (unmatched.size() > 0 || !stack.empty()) {
+			if ((++steps & 1023) == 0 && cancelled()) {
+				delete match;
+				return NULL;
+			}
+
 			if (stack.empty()) {
 				stack.push_back(-1);
 				int u = *(unmatched.begin());
@@ -91,3 +120,131 @@ Map<int>* bipartite_matching(Graph* graph, Set* left, Set* right) {
 
 	return match;
 }
+
+#define INF 0x7fffffff
+
+// advances a dfs from the free left vertex r along the bfs layers, flipping
+// the path if it reaches a free right vertex. pos keeps each vertex's place in
+// its row across the calls of one phase
+bool augment_layered(CSRGraph* graph, signed char* color, int* mate, int* dist, long* pos, int r, std::vector<int>& stack) {
+	stack.clear();
+	stack.push_back(r);
+
+	while (!stack.empty()) {
+		int u = stack.back();
+		if (pos[u] == graph->offsets[u + 1]) {
+			dist[u] = INF;
+			stack.pop_back();
+			continue;
+		}
+
+		int v = graph->nbrs[pos[u]++];
+		if (color[v] != COLOR_RIGHT) {
+			continue;
+		}
+
+		int w = mate[v];
+		if (w == -1) {
+			for (auto it = stack.begin(); it != stack.end(); ++it) {
+				int x = *it;
+				int y = graph->nbrs[pos[x] - 1];
+				mate[x] = y;
+				mate[y] = x;
+			}
+			return true;
+		}
+
+		if (dist[w] == dist[u] + 1) {
+			stack.push_back(w);
+		}
+	}
+
+	return false;
+}
+
+// hopcroft-karp between the vertices colored COLOR_LEFT and COLOR_RIGHT,
+// working on the csr arrays alone so mapped graphs are read sequentially
+// per phase. returns the partner of each vertex (-1 if none), or NULL if
+// cancelled
+int* bipartite_matching(CSRGraph* graph, signed char* color) {
+	int n = graph->n;
+	int* mate = new int[n];
+	int* dist = new int[n];
+	long* pos = new long[n];
+	for (int u = 0; u < n; u++) {
+		mate[u] = -1;
+	}
+
+	// greedy start, the phases only have to fix what it missed
+	for (int u = 0; u < n; u++) {
+		if (color[u] != COLOR_LEFT) {
+			continue;
+		}
+
+		for (int* iv = graph->begin(u); iv != graph->end(u); ++iv) {
+			if (color[*iv] == COLOR_RIGHT && mate[*iv] == -1) {
+				mate[u] = *iv;
+				mate[*iv] = u;
+				break;
+			}
+		}
+	}
+
+	std::vector<int> queue;
+	std::vector<int> stack;
+	while (true) {
+		if (cancelled()) {
+			delete[] mate;
+			mate = NULL;
+			break;
+		}
+
+		queue.clear();
+		for (int u = 0; u < n; u++) {
+			if (color[u] == COLOR_LEFT && mate[u] == -1) {
+				dist[u] = 0;
+				queue.push_back(u);
+			}
+			else {
+				dist[u] = INF;
+			}
+		}
+
+		bool found = false;
+		for (size_t h = 0; h < queue.size(); h++) {
+			int u = queue[h];
+			for (int* iv = graph->begin(u); iv != graph->end(u); ++iv) {
+				if (color[*iv] != COLOR_RIGHT) {
+					continue;
+				}
+
+				int w = mate[*iv];
+				if (w == -1) {
+					found = true;
+				}
+				else if (dist[w] == INF) {
+					dist[w] = dist[u] + 1;
+					queue.push_back(w);
+				}
+			}
+		}
+
+		if (!found) {
+			break;
+		}
+
+		for (int u = 0; u < n; u++) {
+			pos[u] = graph->offsets[u];
+		}
+		// a cancelled phase stops early and is caught at the top of the loop
+		for (int u = 0; u < n && ((u & 1023) != 0 || !cancelled()); u++) {
+			if (color[u] == COLOR_LEFT && mate[u] == -1) {
+				augment_layered(graph, color, mate, dist, pos, u, stack);
+			}
+		}
+	}
+
+	delete[] dist;
+	delete[] pos;
+	return mate;
+}
@@ -4,7 +4,9 @@
 
 #include "setmap.hpp"
 #include "graph.hpp"
+#include "csr.hpp"
 
-Map<int>* bipartite_matching(Graph*, Set*, Set*);
+Map<int>* bipartite_matching(Graph*, Set*, Set*, Map<int>* initial = NULL);
+int* bipartite_matching(CSRGraph*, signed char*);
 
 #endif
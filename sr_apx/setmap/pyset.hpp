@@ -5,12 +5,33 @@
 #include <Python.h>
 #include "setmap.hpp"
 
+// a borrowed set lives inside another object, such as the neighbors of a
+// vertex in a graph, and owner keeps that object alive. readers starts the
+// struct as in PyReadable, and the owner of a borrowed set must be readable too
 typedef struct {
 	PyObject_HEAD
+	int readers;
 	Set* s;
 	bool borrowed;
+	PyObject* owner;
 } PySet;
 
-PyObject* make_PySet(Set*, bool);
+PyObject* make_PySet(Set*, bool, PyObject* owner = NULL);
+
+// one dimensional array of ints ('i') or longs ('l') exported through the
+// buffer protocol, so that numpy.asarray and memoryview share its memory. the
+// array deletes data itself unless owner is given, in which case data lives
+// inside owner and the array keeps it alive
+PyObject* make_PyIntArray(void* data, Py_ssize_t len, char format, PyObject* owner = NULL, bool readonly = false);
+
+// gets a c-contiguous buffer of 4 or 8 byte signed integers from obj. returns
+// false with an exception set if obj has no such buffer, or if an element
+// does not fit in an int
+bool get_int_buffer(PyObject* obj, Py_buffer* view);
+
+// element i of a buffer from get_int_buffer
+static inline long int_buffer_at(Py_buffer* view, Py_ssize_t i) {
+	return view->itemsize == 4 ? ((int*) view->buf)[i] : ((long*) view->buf)[i];
+}
 
 #endif
@@ -89,6 +89,7 @@ public:
 
 	Iterator find(int);
 	Iterator begin();
+	Iterator begin(int);
 	Iterator end();
 
 	void reserve(int);
@@ -263,6 +263,18 @@ typename Map<T>::Iterator Map<T>::begin() {
 	return Iterator(this);
 }
 
+// first element stored at or after the given slot, so that iteration over the
+// max_size() slots can be split into ranges [begin(a), begin(b))
+template<class T>
+typename Map<T>::Iterator Map<T>::begin(int slot) {
+	if (logsize < 0 || slot >= 1 << logsize) {
+		return end();
+	}
+
+	Iterator it(slot - 1, this);
+	return ++it;
+}
+
 template<class T>
 typename Map<T>::Iterator Map<T>::end() {
 	return Iterator(1 << logsize, this);
@@ -1,7 +1,13 @@
 
 #include <Python.h>
+
+#include <climits>
+#include <cstring>
+
 #include "setmap.hpp"
 #include "pyset.hpp"
+#include "pycall.hpp"
+#include "cancel.hpp"
 
 // set type //////////////////////////////
 
@@ -10,10 +16,12 @@ static void Set_dealloc(PySet* self) {
 	if (!self->borrowed) {
 		delete self->s;
 	}
+	Py_XDECREF(self->owner);
 	Py_TYPE(self)->tp_free((PyObject*) self);
 }
 
 static int Set_traverse(PyObject* self, visitproc visit, void* arg) {
+	Py_VISIT(((PySet*) self)->owner);
 	return 0;
 }
 
@@ -43,9 +51,15 @@ static PyObject* Set_contains(PySet* self, PyObject* args) {
 	}
 }
 
+// a borrowed set is part of its owner graph, so it cannot be modified while a
+// computation reads the graph either
+static bool set_in_use(PySet* self) {
+	return in_use((PyObject*) self) || (self->borrowed && self->owner != NULL && in_use(self->owner));
+}
+
 static PyObject* Set_add(PySet* self, PyObject* args) {
 	int u;
-	if (!PyArg_ParseTuple(args, "i", &u)) {
+	if (!PyArg_ParseTuple(args, "i", &u) || set_in_use(self)) {
 		return NULL;
 	}
 
@@ -55,7 +69,7 @@ static PyObject* Set_add(PySet* self, PyObject* args) {
 
 static PyObject* Set_remove(PySet* self, PyObject* args) {
 	int u;
-	if (!PyArg_ParseTuple(args, "i", &u)) {
+	if (!PyArg_ParseTuple(args, "i", &u) || set_in_use(self)) {
 		return NULL;
 	}
 
@@ -77,6 +91,102 @@ static long Set_size_len(PyObject* self) {
 	return temp->s->size();
 }
 
+// the elements in iteration order, as an array of ints
+static PyObject* Set_toarray(PySet* self) {
+	int n = self->s->size();
+	int* data = new int[n > 0 ? n : 1];
+	{
+		WithoutGIL nogil({(PyObject*) self});
+		int i = 0;
+		for (Set::Iterator it = self->s->begin(); it != self->s->end(); ++it) {
+			data[i++] = *it;
+		}
+	}
+
+	return make_PyIntArray(data, n, 'i');
+}
+
+static PyObject* Set_fromarray(PyObject* cls, PyObject* args) {
+	PyObject* a;
+	if (!PyArg_ParseTuple(args, "O", &a)) {
+		return NULL;
+	}
+
+	Py_buffer view;
+	if (!get_int_buffer(a, &view)) {
+		return NULL;
+	}
+
+	Py_ssize_t n = view.len / view.itemsize;
+	Set* set = new Set();
+	{
+		WithoutGIL nogil({});
+		set->reserve(n);
+		for (Py_ssize_t i = 0; i < n; i++) {
+			set->insert(int_buffer_at(&view, i));
+		}
+	}
+	PyBuffer_Release(&view);
+
+	return make_PySet(set, false);
+}
+
+// pickles the elements as one buffer of ints, which protocol 5 can hand
+// over out of band
+static PyObject* Set_reduceex(PySet* self, PyObject* args) {
+	int protocol;
+	if (!PyArg_ParseTuple(args, "i", &protocol)) {
+		return NULL;
+	}
+
+	PyObject* data = PyBytes_FromStringAndSize(NULL, self->s->size() * sizeof(int));
+	if (data != NULL) {
+		WithoutGIL nogil({(PyObject*) self});
+		int* out = (int*) PyBytes_AS_STRING(data);
+		for (Set::Iterator it = self->s->begin(); it != self->s->end(); ++it) {
+			*out++ = *it;
+		}
+	}
+
+	PyObject* unpickle = PyObject_GetAttrString((PyObject*) Py_TYPE(self), "_unpickle");
+	PyObject* buffer = pickle_buffer(data, protocol);
+	if (unpickle == NULL || buffer == NULL) {
+		Py_XDECREF(unpickle);
+		Py_XDECREF(buffer);
+		return NULL;
+	}
+	return Py_BuildValue("N(N)", unpickle, buffer);
+}
+
+static PyObject* Set_unpickle(PyObject* cls, PyObject* args) {
+	Py_buffer view;
+	if (!PyArg_ParseTuple(args, "y*", &view)) {
+		return NULL;
+	}
+	if (view.len % sizeof(int) != 0) {
+		PyBuffer_Release(&view);
+		PyErr_SetString(PyExc_ValueError, "not a pickled set");
+		return NULL;
+	}
+
+	// the buffer need not be aligned
+	Py_ssize_t n = view.len / sizeof(int);
+	Set* set = new Set();
+	{
+		WithoutGIL nogil({});
+		set->reserve(n);
+		const char* p = (const char*) view.buf;
+		for (Py_ssize_t i = 0; i < n; i++) {
+			int u;
+			memcpy(&u, p + i * sizeof(int), sizeof(int));
+			set->insert(u);
+		}
+	}
+	PyBuffer_Release(&view);
+
+	return make_PySet(set, false);
+}
+
 static PyMethodDef Set_methods[] = {
 	{"contains", (PyCFunction) Set_contains, METH_VARARGS, "checks if element in set"},
 	{"__contains__", (PyCFunction) Set_contains, METH_VARARGS, "checks if element in set"},
@@ -84,6 +194,10 @@ static PyMethodDef Set_methods[] = {
 	{"__sizeof__", (PyCFunction) Set_size, METH_NOARGS, "gets number of elements in the set"},
 	{"add", (PyCFunction) Set_add, METH_VARARGS, "adds an element to the set"},
 	{"remove", (PyCFunction) Set_remove, METH_VARARGS, "removes an element from the set"},
+	{"to_array", (PyCFunction) Set_toarray, METH_NOARGS, "copies the elements into an int array supporting the buffer protocol"},
+	{"from_array", (PyCFunction) Set_fromarray, METH_VARARGS | METH_CLASS, "creates a set from a buffer of ints, such as a numpy array"},
+	{"__reduce_ex__", (PyCFunction) Set_reduceex, METH_VARARGS, "pickles the set as a buffer of ints, out of band with protocol 5"},
+	{"_unpickle", (PyCFunction) Set_unpickle, METH_VARARGS | METH_CLASS, "rebuilds a set from the buffer written by pickling"},
 	{NULL},
 };
 
@@ -146,7 +260,7 @@ static PyMethodDef SetIter_methods[] = {
 
 PyTypeObject SetIter_type = {
 	PyVarObject_HEAD_INIT(NULL, 0)
-	.tp_name = "setmap.SetIterator",
+	.tp_name = "sr_apx.setmap.SetIterator",
 	.tp_basicsize = sizeof(PySetIter),
 	.tp_itemsize = 0,
 	.tp_dealloc = (destructor) SetIter_dealloc,
@@ -174,7 +288,7 @@ static PyObject* Set_iter(PySet* self) {
 
 static PyTypeObject Set_type = {
 	PyVarObject_HEAD_INIT(NULL, 0)
-	.tp_name = "setmap.Set",
+	.tp_name = "sr_apx.setmap.Set",
 	.tp_basicsize = sizeof(PySet),
 	.tp_itemsize = 0,
 	.tp_dealloc = (destructor) Set_dealloc,
@@ -191,6 +305,88 @@ static PyTypeObject Set_type = {
 	.tp_free = PyObject_GC_Del,
 };
 
+// int array type ///////////////////////////
+
+typedef struct {
+	PyObject_HEAD
+	void* data;
+	Py_ssize_t len;
+	Py_ssize_t itemsize;
+	char format[2];
+	bool readonly;
+	PyObject* owner;
+} PyIntArray;
+
+static void IntArray_dealloc(PyIntArray* self) {
+	if (self->owner != NULL) {
+		Py_DECREF(self->owner);
+	}
+	else if (self->itemsize == 4) {
+		delete[] (int*) self->data;
+	}
+	else {
+		delete[] (long*) self->data;
+	}
+	Py_TYPE(self)->tp_free((PyObject*) self);
+}
+
+static int IntArray_getbuffer(PyIntArray* self, Py_buffer* view, int flags) {
+	if ((flags & PyBUF_WRITABLE) && self->readonly) {
+		PyErr_SetString(PyExc_BufferError, "array is read-only");
+		view->obj = NULL;
+		return -1;
+	}
+
+	view->obj = (PyObject*) self;
+	Py_INCREF(self);
+	view->buf = self->data;
+	view->len = self->len * self->itemsize;
+	view->readonly = self->readonly;
+	view->itemsize = self->itemsize;
+	view->format = (flags & PyBUF_FORMAT) ? self->format : NULL;
+	view->ndim = 1;
+	view->shape = (flags & PyBUF_ND) ? &self->len : NULL;
+	view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? &self->itemsize : NULL;
+	view->suboffsets = NULL;
+	view->internal = NULL;
+	return 0;
+}
+
+static Py_ssize_t IntArray_len(PyIntArray* self) {
+	return self->len;
+}
+
+static PyObject* IntArray_item(PyIntArray* self, Py_ssize_t i) {
+	if (i < 0 || i >= self->len) {
+		PyErr_SetString(PyExc_IndexError, "array index out of range");
+		return NULL;
+	}
+
+	return PyLong_FromLong(self->itemsize == 4 ? ((int*) self->data)[i] : ((long*) self->data)[i]);
+}
+
+static PyBufferProcs IntArray_buffer_procs = {
+	.bf_getbuffer = (getbufferproc) IntArray_getbuffer,
+	.bf_releasebuffer = NULL,
+};
+
+static PySequenceMethods IntArray_sequence_methods = {
+	.sq_length = (lenfunc) IntArray_len,
+	.sq_item = (ssizeargfunc) IntArray_item,
+};
+
+static PyTypeObject IntArray_type = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "sr_apx.setmap.IntArray",
+	.tp_basicsize = sizeof(PyIntArray),
+	.tp_itemsize = 0,
+	.tp_dealloc = (destructor) IntArray_dealloc,
+	.tp_as_sequence = &IntArray_sequence_methods,
+	.tp_as_buffer = &IntArray_buffer_procs,
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_doc = "array of ints exported through the buffer protocol, see numpy.asarray or memoryview",
+};
+
 static PyModuleDef setmap_module = {
 	PyModuleDef_HEAD_INIT,
 	.m_name = "setmap",
@@ -200,7 +396,7 @@ static PyModuleDef setmap_module = {
 
 PyMODINIT_FUNC PyInit_lib_setmap() {
 	PyObject* m;
-	if (PyType_Ready(&Set_type) < 0 || PyType_Ready(&SetIter_type) < 0) {
+	if (PyType_Ready(&Set_type) < 0 || PyType_Ready(&SetIter_type) < 0 || PyType_Ready(&IntArray_type) < 0) {
 		return NULL;
 	}
 
@@ -223,14 +419,89 @@ PyMODINIT_FUNC PyInit_lib_setmap() {
 		return NULL;
 	}
 
+	Py_INCREF(&IntArray_type);
+	if (PyModule_AddObject(m, "IntArray", (PyObject*) &IntArray_type) < 0) {
+		Py_DECREF(&IntArray_type);
+		Py_DECREF(m);
+		return NULL;
+	}
+
     return m;
 }
 
 // cpp api //////////////////////////////////////////////
 
-PyObject* make_PySet(Set* base, bool b) {
+// the solvers return NULL when cancelled or when they cannot handle their
+// input, which becomes an exception instead of a set with nothing in it
+PyObject* make_PySet(Set* base, bool b, PyObject* owner) {
+	if (base == NULL) {
+		if (cancelled()) {
+			set_cancelled_error();
+		}
+		else {
+			PyErr_SetString(PyExc_ValueError, "no solution for this input");
+		}
+		return NULL;
+	}
+
 	PySet* ret = (PySet*) Set_new(&Set_type, NULL, NULL);
 	ret->borrowed = b;
 	ret->s = base;
+	Py_XINCREF(owner);
+	ret->owner = owner;
 	return (PyObject*) ret;
 }
+
+PyObject* make_PyIntArray(void* data, Py_ssize_t len, char format, PyObject* owner, bool readonly) {
+	// other modules can return arrays before sr_apx.setmap is imported
+	if (PyType_Ready(&IntArray_type) < 0) {
+		return NULL;
+	}
+
+	PyIntArray* ret = PyObject_New(PyIntArray, &IntArray_type);
+	if (ret == NULL) {
+		return NULL;
+	}
+
+	ret->data = data;
+	ret->len = len;
+	ret->itemsize = format == 'i' ? sizeof(int) : sizeof(long);
+	ret->format[0] = format;
+	ret->format[1] = '\0';
+	ret->readonly = readonly;
+	Py_XINCREF(owner);
+	ret->owner = owner;
+	return (PyObject*) ret;
+}
+
+bool get_int_buffer(PyObject* obj, Py_buffer* view) {
+	if (PyObject_GetBuffer(obj, view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) {
+		return false;
+	}
+
+	// native or little endian signed integers, as numpy and array write them
+	const char* f = view->format;
+	if (*f == '@' || *f == '=' || *f == '<') {
+		++f;
+	}
+	bool ok = (*f == 'i' || *f == 'l' || *f == 'q') && f[1] == '\0' && (view->itemsize == 4 || view->itemsize == 8);
+	if (!ok) {
+		PyErr_Format(PyExc_TypeError, "expected a buffer of 32 or 64 bit ints, got format '%s'", view->format);
+		PyBuffer_Release(view);
+		return false;
+	}
+
+	// the elements are read as ints, so 64 bit ones must fit in one
+	if (view->itemsize == 8) {
+		Py_ssize_t len = view->len / 8;
+		for (Py_ssize_t i = 0; i < len; i++) {
+			long x = ((long*) view->buf)[i];
+			if (x < INT_MIN || x > INT_MAX) {
+				PyErr_Format(PyExc_OverflowError, "element %zd (%ld) does not fit in an int", i, x);
+				PyBuffer_Release(view);
+				return false;
+			}
+		}
+	}
+	return true;
+}
@@ -0,0 +1,23 @@
+
+#include "cancel.hpp"
+
+#include <cstddef>
+
+static thread_local const std::atomic<bool>* current_flag = NULL;
+
+bool cancelled() {
+	return current_flag != NULL && current_flag->load(std::memory_order_relaxed);
+}
+
+const std::atomic<bool>* cancel_flag() {
+	return current_flag;
+}
+
+CancelScope::CancelScope(const std::atomic<bool>* flag) {
+	previous = current_flag;
+	current_flag = flag;
+}
+
+CancelScope::~CancelScope() {
+	current_flag = previous;
+}
@@ -0,0 +1,22 @@
+
+#ifndef CANCEL_H
+#define CANCEL_H
+
+#include <atomic>
+
+// cooperative cancellation: a thread installs a flag with CancelScope and the
+// long running routines poll cancelled(), returning NULL once it is set
+bool cancelled();
+
+// the flag installed on the calling thread, for handing it to worker threads
+const std::atomic<bool>* cancel_flag();
+
+class CancelScope {
+private:
+	const std::atomic<bool>* previous;
+public:
+	CancelScope(const std::atomic<bool>*);
+	~CancelScope();
+};
+
+#endif
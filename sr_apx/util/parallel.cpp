@@ -0,0 +1,51 @@
+
+#include "parallel.hpp"
+#include "cancel.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+int num_threads() {
+	int t = std::thread::hardware_concurrency();
+	return t > 0 ? t : 1;
+}
+
+// runs f(0), ..., f(n-1) on a pool of worker threads, handing out indices
+// one at a time so that a few expensive tasks do not stall the rest
+void parallel_for(int n, const std::function<void(int)>& f, int threads) {
+	if (threads <= 0) {
+		threads = num_threads();
+	}
+	if (threads > n) {
+		threads = n;
+	}
+
+	if (threads <= 1) {
+		for (int i = 0; i < n; i++) {
+			f(i);
+		}
+		return;
+	}
+
+	// the workers see the cancellation flag of the calling thread
+	const std::atomic<bool>* flag = cancel_flag();
+	std::atomic<int> next(0);
+	auto worker = [&]() {
+		CancelScope scope(flag);
+		int i;
+		while ((i = next++) < n) {
+			f(i);
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (int t = 1; t < threads; t++) {
+		pool.push_back(std::thread(worker));
+	}
+	worker();
+
+	for (auto it = pool.begin(); it != pool.end(); ++it) {
+		it->join();
+	}
+}
@@ -0,0 +1,10 @@
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <functional>
+
+int num_threads();
+void parallel_for(int, const std::function<void(int)>&, int threads = 0);
+
+#endif
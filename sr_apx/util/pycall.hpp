@@ -0,0 +1,88 @@
+
+#ifndef PYCALL_H
+#define PYCALL_H
+
+#include <Python.h>
+
+#include <initializer_list>
+#include <vector>
+
+// common start of PyGraph and PySet: the number of calls reading the object
+// with the gil released, during which it must not be modified
+typedef struct {
+	PyObject_HEAD
+	int readers;
+} PyReadable;
+
+// releases the gil for its lifetime, so that solves on different graphs run
+// in parallel from python threads. the graphs and sets given are marked as
+// read until the gil is taken back, and their methods that modify them raise
+// instead of racing with the native code. the arguments of a call keep them
+// alive, and any python objects for the results must be made afterwards
+class WithoutGIL {
+private:
+	std::vector<PyReadable*> objects;
+	PyThreadState* state;
+
+	template <typename T>
+	void release(const T& read) {
+		for (auto it = read.begin(); it != read.end(); ++it) {
+			if (*it != NULL && *it != Py_None) {
+				objects.push_back((PyReadable*) *it);
+				++objects.back()->readers;
+			}
+		}
+		state = PyEval_SaveThread();
+	}
+public:
+	WithoutGIL(std::initializer_list<PyObject*> read) {release(read);};
+	WithoutGIL(const std::vector<PyObject*>& read) {release(read);};
+
+	~WithoutGIL() {
+		PyEval_RestoreThread(state);
+		for (auto it = objects.begin(); it != objects.end(); ++it) {
+			--(*it)->readers;
+		}
+	}
+};
+
+// sets a RuntimeError and returns true if the object is being read without
+// the gil
+static inline bool in_use(PyObject* o) {
+	if (((PyReadable*) o)->readers > 0) {
+		PyErr_SetString(PyExc_RuntimeError, "cannot modify a graph or set while a computation is reading it");
+		return true;
+	}
+	return false;
+}
+
+// wraps bytes written for pickling in a PickleBuffer from protocol 5 on, so
+// that a buffer_callback can take it out of band instead of copying it into
+// the stream. steals the reference to data, which may be NULL after an error
+static inline PyObject* pickle_buffer(PyObject* data, int protocol) {
+	if (data == NULL || protocol < 5) {
+		return data;
+	}
+
+	PyObject* buffer = PyPickleBuffer_FromObject(data);
+	Py_DECREF(data);
+	return buffer;
+}
+
+// raises concurrent.futures.CancelledError, which the solvers report when
+// the job running them is cancelled
+static inline void set_cancelled_error() {
+	PyObject* futures = PyImport_ImportModule("concurrent.futures");
+	if (futures == NULL) {
+		return;
+	}
+
+	PyObject* error = PyObject_GetAttrString(futures, "CancelledError");
+	Py_DECREF(futures);
+	if (error != NULL) {
+		PyErr_SetString(error, "computation was cancelled");
+		Py_DECREF(error);
+	}
+}
+
+#endif
@@ -1,6 +1,8 @@
 
 #include "util.hpp"
 
+#include <chrono>
+
 int log2(int n) {
 	int k = 0;
 	while ((1 << k) < n) {
@@ -17,3 +19,9 @@ int pow(int b, int e) {
 
 	return x;
 }
+
+// seconds on a monotonic clock, used for time budgets
+double wall_time() {
+	auto now = std::chrono::steady_clock::now().time_since_epoch();
+	return std::chrono::duration<double>(now).count();
+}
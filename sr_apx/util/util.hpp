@@ -4,5 +4,6 @@
 
 int log2(int);
 int pow(int, int);
+double wall_time();
 
 #endif
@@ -1,8 +1,14 @@
 
 #include "vc_apx.hpp"
+#include "cancel.hpp"
+
 #include <vector>
 
 Set* dfs_apx(Graph* g) {
+	if (cancelled()) {
+		return NULL;
+	}
+
 	Set* cover = new Set();
 
 	std::vector<int> stack;
@@ -10,7 +16,13 @@ Set* dfs_apx(Graph* g) {
 
 	auto vitr = g->begin();
 
+	int steps = 0;
 	while (visited.size() < g->size()) {
+		if ((++steps & 1023) == 0 && cancelled()) {
+			delete cover;
+			return NULL;
+		}
+
 		int current;
 		if (stack.empty()) {
 			while (visited.contains(*vitr)) {
@@ -69,6 +81,10 @@ void remove_vertex(Graph* g, Map<int>& deg, Map<Set>& revdeg, int u) {
 }
 
 Set* heuristic_apx(Graph* g) {
+	if (cancelled()) {
+		return NULL;
+	}
+
 	Set* cover = new Set();
 
 	Map<int> deg;
@@ -83,7 +99,13 @@ Set* heuristic_apx(Graph* g) {
 		maxdeg = degree > maxdeg ? degree : maxdeg;
 	}
 
+	int steps = 0;
 	while (deg.size() > 0) {
+		if ((++steps & 1023) == 0 && cancelled()) {
+			delete cover;
+			return NULL;
+		}
+
 		while (revdeg[maxdeg].empty()) {
 			--maxdeg;
 		}
@@ -98,6 +120,10 @@ Set* heuristic_apx(Graph* g) {
 }
 
 Set* std_apx(Graph* g) {
+	if (cancelled()) {
+		return NULL;
+	}
+
 	Set* cover = new Set();
 
 	Map<int> deg;
@@ -112,7 +138,13 @@ Set* std_apx(Graph* g) {
 		maxdeg = degree > maxdeg ? degree : maxdeg;
 	}
 
+	int steps = 0;
 	while (deg.size() > 0) {
+		if ((++steps & 1023) == 0 && cancelled()) {
+			delete cover;
+			return NULL;
+		}
+
 		while (revdeg[maxdeg].empty()) {
 			--maxdeg;
 		}
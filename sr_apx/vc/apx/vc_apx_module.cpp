@@ -6,6 +6,7 @@
 #include "setmap.hpp"
 #include "pyset.hpp"
 #include "pygraph.hpp"
+#include "pycall.hpp"
 
 static PyObject* vc_apx_dfsapx(PyObject* self, PyObject* args) {
 	PyObject* graph;
@@ -13,8 +14,12 @@ static PyObject* vc_apx_dfsapx(PyObject* self, PyObject* args) {
 		return NULL;
 	}
 
-	Graph* g = ((PyGraph*) graph)->g;
-	Set* cover = dfs_apx(g);
+	Graph* g = get_graph(graph);
+	Set* cover;
+	{
+		WithoutGIL nogil({graph});
+		cover = dfs_apx(g);
+	}
 	return make_PySet(cover, false);
 }
 
@@ -24,8 +29,12 @@ static PyObject* vc_apx_stdapx(PyObject* self, PyObject* args) {
 		return NULL;
 	}
 
-	Graph* g = ((PyGraph*) graph)->g;
-	Set* cover = std_apx(g);
+	Graph* g = get_graph(graph);
+	Set* cover;
+	{
+		WithoutGIL nogil({graph});
+		cover = std_apx(g);
+	}
 	return make_PySet(cover, false);
 }
 
@@ -35,8 +44,12 @@ static PyObject* vc_apx_heuristic(PyObject* self, PyObject* args) {
 		return NULL;
 	}
 
-	Graph* g = ((PyGraph*) graph)->g;
-	Set* cover = heuristic_apx(g);
+	Graph* g = get_graph(graph);
+	Set* cover;
+	{
+		WithoutGIL nogil({graph});
+		cover = heuristic_apx(g);
+	}
 	return make_PySet(cover, false);
 }
 
@@ -0,0 +1,2 @@
+
+from .lib_vc_batch import solve_batch
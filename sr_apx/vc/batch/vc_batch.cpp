@@ -0,0 +1,192 @@
+
+#include "vc_batch.hpp"
+#include "vc_apx.hpp"
+#include "vc_split.hpp"
+#include "vc_exact.hpp"
+#include "vc_bound.hpp"
+#include "bipartite.hpp"
+#include "formats.hpp"
+#include "lift_engine.hpp"
+#include "parallel.hpp"
+#include "util.hpp"
+
+#define NUM_APX 5
+
+static const char* apx_names[NUM_APX] = {"dfs_apx", "std_apx", "heuristic_apx", "split_std_apx", "split_heuristic_apx"};
+
+static Set* (*apx_functions[NUM_APX])(Graph*) = {
+	dfs_apx, std_apx, heuristic_apx, split_std_apx, split_heuristic_apx
+};
+
+static int apx_index(const std::string& name) {
+	for (int a = 0; a < NUM_APX; a++) {
+		if (name == apx_names[a]) {
+			return a;
+		}
+	}
+	return -1;
+}
+
+static bool is_lift(const std::string& name) {
+	for (int l = 0; l < NUM_LIFTS; l++) {
+		if (name == lift_names[l]) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool batch_algorithm(const std::string& name) {
+	return apx_index(name) >= 0 || is_lift(name) || name == "octset" || name == "partial" || name == "lower_bound";
+}
+
+// minimum cover of the graph without the octset, using the coloring found by
+// verify_bipartite as the side for bip_exact
+static Set* partial_cover(Graph* graph, Set* octset) {
+	Set** od = verify_bipartite(graph, octset);
+	Set* bippart = new Set();
+	for (int s = 1; s <= 2; s++) {
+		for (Set::Iterator it = od[s]->begin(); it != od[s]->end(); ++it) {
+			bippart->insert(*it);
+		}
+	}
+
+	Graph* bipgraph = graph->subgraph(bippart);
+	Set* partial = bipgraph == NULL ? NULL : bip_exact(bipgraph, od[1]);
+
+	delete bipgraph;
+	delete bippart;
+	for (int s = 0; s < 3; s++) {
+		delete od[s];
+	}
+	delete[] od;
+	return partial;
+}
+
+static void set_row(BatchResult& row, Set* cover, double time, bool covers) {
+	row.size = cover == NULL ? -1 : cover->size();
+	row.time = time;
+	if (covers) {
+		row.cover = cover;
+	}
+	else {
+		delete cover;
+	}
+}
+
+// fills the rows of one input, rows[a] for algorithms[a]
+static void solve_graph(Graph* graph, const std::vector<std::string>& algorithms, BatchResult* rows, bool covers) {
+	if (graph == NULL) {
+		return;
+	}
+
+	std::vector<std::string> lifts;
+	bool needoct = false;
+	for (auto it = algorithms.begin(); it != algorithms.end(); ++it) {
+		if (is_lift(*it)) {
+			lifts.push_back(*it);
+		}
+		if (is_lift(*it) || *it == "octset" || *it == "partial") {
+			needoct = true;
+		}
+	}
+
+	double octtime = 0;
+	double partialtime = 0;
+	Set* octset = NULL;
+	Set* partial = NULL;
+	std::vector<LiftResult> lifted;
+	if (needoct) {
+		double start = wall_time();
+		octset = vertex_delete(graph);
+		octtime = wall_time() - start;
+
+		if (octset != NULL) {
+			start = wall_time();
+			partial = partial_cover(graph, octset);
+			partialtime = wall_time() - start;
+		}
+
+		if (partial != NULL && !lifts.empty()) {
+			LiftEngine engine(graph, octset, partial);
+			lifted = engine.run(lifts);
+		}
+	}
+
+	int next = 0;
+	for (size_t a = 0; a < algorithms.size(); a++) {
+		const std::string& name = algorithms[a];
+		BatchResult& row = rows[a];
+
+		int apx = apx_index(name);
+		if (apx >= 0) {
+			double start = wall_time();
+			Set* cover = apx_functions[apx](graph);
+			set_row(row, cover, wall_time() - start, covers);
+		}
+		else if (name == "lower_bound") {
+			LowerBounds lb = lower_bounds(graph);
+			row.size = lb.best;
+			row.time = lb.time;
+		}
+		else if (name == "octset") {
+			row.size = octset == NULL ? -1 : octset->size();
+			row.time = octtime;
+		}
+		else if (name == "partial") {
+			row.size = partial == NULL ? -1 : partial->size();
+			row.time = partialtime;
+		}
+		else if (next < (int) lifted.size()) {
+			set_row(row, lifted[next].cover, lifted[next].time, covers);
+			++next;
+		}
+	}
+
+	// the octset and partial go to their first rows, if covers are kept
+	for (size_t a = 0; covers && a < algorithms.size(); a++) {
+		if (algorithms[a] == "octset" && rows[a].cover == NULL) {
+			rows[a].cover = octset;
+			octset = NULL;
+		}
+		else if (algorithms[a] == "partial" && rows[a].cover == NULL) {
+			rows[a].cover = partial;
+			partial = NULL;
+		}
+	}
+	delete octset;
+	delete partial;
+}
+
+static std::vector<BatchResult> empty_rows(int inputs, const std::vector<std::string>& algorithms) {
+	std::vector<BatchResult> rows(inputs * algorithms.size());
+	for (int i = 0; i < inputs; i++) {
+		for (size_t a = 0; a < algorithms.size(); a++) {
+			BatchResult& row = rows[i * algorithms.size() + a];
+			row.input = i;
+			row.algorithm = algorithms[a];
+			row.size = -1;
+			row.time = 0;
+			row.cover = NULL;
+		}
+	}
+	return rows;
+}
+
+std::vector<BatchResult> solve_batch(const std::vector<Graph*>& graphs, const std::vector<std::string>& algorithms, bool covers, int threads) {
+	std::vector<BatchResult> rows = empty_rows(graphs.size(), algorithms);
+	parallel_for(graphs.size(), [&](int i) {
+		solve_graph(graphs[i], algorithms, &rows[i * algorithms.size()], covers);
+	}, threads);
+	return rows;
+}
+
+std::vector<BatchResult> solve_batch(const std::vector<std::string>& files, const std::vector<std::string>& algorithms, bool covers, int threads) {
+	std::vector<BatchResult> rows = empty_rows(files.size(), algorithms);
+	parallel_for(files.size(), [&](int i) {
+		Graph* graph = read_graph(files[i].c_str(), 1);
+		solve_graph(graph, algorithms, &rows[i * algorithms.size()], covers);
+		delete graph;
+	}, threads);
+	return rows;
+}
@@ -0,0 +1,38 @@
+
+#ifndef VC_BATCH_H
+#define VC_BATCH_H
+
+#include <string>
+#include <vector>
+
+#include "graph.hpp"
+#include "setmap.hpp"
+
+// one row of a batch: an algorithm run on one of the inputs. size is -1 if
+// the input could not be read or the run was cancelled, and cover is NULL
+// unless covers were asked for
+struct BatchResult {
+	int input;
+	std::string algorithm;
+	int size;
+	double time;
+	Set* cover;
+};
+
+// checks that solve_batch knows an algorithm. these are the apx algorithms
+// by function name (dfs_apx, std_apx, heuristic_apx, split_std_apx,
+// split_heuristic_apx), octset and partial for the odd cycle transversal and
+// the bipartite cover of the rest, the names of LiftEngine, and lower_bound
+bool batch_algorithm(const std::string&);
+
+// runs every algorithm on every graph, with the graphs spread over threads
+// (all cores if not positive). the octset and partial are computed once per
+// graph and shared by the lifts, whose times do not include them. rows are
+// ordered by input and then algorithm
+std::vector<BatchResult> solve_batch(const std::vector<Graph*>&, const std::vector<std::string>&, bool covers = false, int threads = 0);
+
+// as above on files in any format read_graph knows, each read by the thread
+// solving it and freed once it is done
+std::vector<BatchResult> solve_batch(const std::vector<std::string>&, const std::vector<std::string>&, bool covers = false, int threads = 0);
+
+#endif
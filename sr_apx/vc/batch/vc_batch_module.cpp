@@ -0,0 +1,166 @@
+#include <Python.h>
+
+#include "vc_batch.hpp"
+#include "pygraph.hpp"
+#include "pyset.hpp"
+#include "pycall.hpp"
+
+// the Graph type, imported from sr_apx.graph when the module loads, so that
+// subclasses of it are accepted too
+static PyTypeObject* graph_type = NULL;
+
+static bool is_graph(PyObject* o) {
+	return PyObject_TypeCheck(o, graph_type);
+}
+
+// copies a cover into an int array and deletes it, None for no cover
+static PyObject* cover_array(Set* cover) {
+	if (cover == NULL) {
+		Py_RETURN_NONE;
+	}
+
+	int n = cover->size();
+	int* data = new int[n > 0 ? n : 1];
+	int i = 0;
+	for (Set::Iterator it = cover->begin(); it != cover->end(); ++it) {
+		data[i++] = *it;
+	}
+	delete cover;
+	return make_PyIntArray(data, n, 'i');
+}
+
+// columns of the result table, one entry per row
+static PyObject* make_table(std::vector<BatchResult>& rows, bool covers) {
+	Py_ssize_t n = rows.size();
+	int* inputs = new int[n > 0 ? n : 1];
+	int* sizes = new int[n > 0 ? n : 1];
+	PyObject* algorithms = PyList_New(n);
+	PyObject* times = PyList_New(n);
+	PyObject* coverlist = covers ? PyList_New(n) : NULL;
+	for (Py_ssize_t i = 0; i < n; i++) {
+		inputs[i] = rows[i].input;
+		sizes[i] = rows[i].size;
+		PyList_SET_ITEM(algorithms, i, PyUnicode_FromString(rows[i].algorithm.c_str()));
+		PyList_SET_ITEM(times, i, PyFloat_FromDouble(rows[i].time));
+		if (covers) {
+			PyList_SET_ITEM(coverlist, i, cover_array(rows[i].cover));
+		}
+	}
+
+	PyObject* table = Py_BuildValue("{sNsNsNsN}",
+		"input", make_PyIntArray(inputs, n, 'i'),
+		"algorithm", algorithms,
+		"size", make_PyIntArray(sizes, n, 'i'),
+		"time", times);
+	if (table != NULL && covers) {
+		PyDict_SetItemString(table, "cover", coverlist);
+	}
+	Py_XDECREF(coverlist);
+	return table;
+}
+
+static PyObject* vc_batch_solvebatch(PyObject* self, PyObject* args, PyObject* kwargs) {
+	static const char* keywords[] = {"inputs", "algorithms", "covers", "threads", NULL};
+	PyObject* inputs;
+	PyObject* names;
+	int covers = 0;
+	int threads = 0;
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|pi", (char**) keywords, &inputs, &names, &covers, &threads)) {
+		return NULL;
+	}
+
+	PyObject* inputseq = PySequence_Fast(inputs, "inputs must be a sequence of paths or graphs");
+	if (inputseq == NULL) {
+		return NULL;
+	}
+	PyObject* nameseq = PySequence_Fast(names, "algorithms must be a sequence of names");
+	if (nameseq == NULL) {
+		Py_DECREF(inputseq);
+		return NULL;
+	}
+
+	std::vector<std::string> algorithms;
+	for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(nameseq); i++) {
+		const char* name = PyUnicode_AsUTF8(PySequence_Fast_GET_ITEM(nameseq, i));
+		if (name == NULL || !batch_algorithm(name)) {
+			if (name != NULL) {
+				PyErr_Format(PyExc_ValueError, "unknown algorithm %s", name);
+			}
+			Py_DECREF(inputseq);
+			Py_DECREF(nameseq);
+			return NULL;
+		}
+		algorithms.push_back(name);
+	}
+	Py_DECREF(nameseq);
+
+	// graphs are solved in place, paths are read by the workers
+	std::vector<PyObject*> graphobjects;
+	std::vector<Graph*> graphs;
+	std::vector<std::string> files;
+	Py_ssize_t n = PySequence_Fast_GET_SIZE(inputseq);
+	for (Py_ssize_t i = 0; i < n; i++) {
+		PyObject* o = PySequence_Fast_GET_ITEM(inputseq, i);
+		if (is_graph(o)) {
+			graphobjects.push_back(o);
+			graphs.push_back(get_graph(o));
+			continue;
+		}
+
+		PyObject* path;
+		if (!PyUnicode_FSConverter(o, &path)) {
+			Py_DECREF(inputseq);
+			return NULL;
+		}
+		files.push_back(PyBytes_AS_STRING(path));
+		Py_DECREF(path);
+	}
+
+	if (!graphs.empty() && !files.empty()) {
+		PyErr_SetString(PyExc_TypeError, "inputs must be all paths or all graphs");
+		Py_DECREF(inputseq);
+		return NULL;
+	}
+
+	std::vector<BatchResult> rows;
+	{
+		WithoutGIL nogil(graphobjects);
+		if (files.empty()) {
+			rows = solve_batch(graphs, algorithms, covers, threads);
+		}
+		else {
+			rows = solve_batch(files, algorithms, covers, threads);
+		}
+	}
+	Py_DECREF(inputseq);
+
+	return make_table(rows, covers);
+}
+
+static PyMethodDef vc_batch_methods[] = {
+	{"solve_batch", (PyCFunction) vc_batch_solvebatch, METH_VARARGS | METH_KEYWORDS, "runs each algorithm on each graph or graph file in parallel and returns a table of columns input, algorithm, size, time and, if asked for, cover"},
+	{NULL},
+};
+
+static struct PyModuleDef vc_batch_module = {
+	PyModuleDef_HEAD_INIT,
+	"vc_batch",
+	"Python interface for solving many graphs in one call",
+	-1,
+	vc_batch_methods
+};
+
+PyMODINIT_FUNC PyInit_lib_vc_batch() {
+	PyObject* graph = PyImport_ImportModule("sr_apx.graph");
+	if (graph == NULL) {
+		return NULL;
+	}
+
+	graph_type = (PyTypeObject*) PyObject_GetAttrString(graph, "Graph");
+	Py_DECREF(graph);
+	if (graph_type == NULL) {
+		return NULL;
+	}
+
+	return PyModule_Create(&vc_batch_module);
+}
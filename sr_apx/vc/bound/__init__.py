@@ -0,0 +1,2 @@
+
+from .lib_vc_bound import lower_bounds, lower_bound, verify_cover
@@ -0,0 +1,277 @@
+
+#include <algorithm>
+#include <vector>
+
+#include "vc_bound.hpp"
+#include "lp_kernel.hpp"
+#include "parallel.hpp"
+#include "util.hpp"
+
+// size of a greedy maximal matching, every cover takes an endpoint of each edge
+int matching_bound(CSRGraph* g) {
+	char* matched = new char[g->n]();
+	int bound = 0;
+	for (int u = 0; u < g->n; u++) {
+		if (matched[u]) {
+			continue;
+		}
+
+		for (int* iv = g->begin(u); iv != g->end(u); ++iv) {
+			if (!matched[*iv]) {
+				matched[u] = 1;
+				matched[*iv] = 1;
+				++bound;
+				break;
+			}
+		}
+	}
+
+	delete[] matched;
+	return bound;
+}
+
+// the lp optimum from the double cover matching, rounded up
+int lp_bound(CSRGraph* g) {
+	LPKernel k(g);
+	return k.bound();
+}
+
+// packs vertex disjoint cliques, odd cycles and edges greedily. a cover takes
+// all but one vertex of a clique, more than half of an odd cycle and one end
+// of an edge, and the pieces share no vertices, so these add up
+int packing_bound(CSRGraph* g) {
+	int n = g->n;
+	char* used = new char[n]();
+	char* tried = new char[n]();
+	int* stamp = new int[n];
+	int* parent = new int[n];
+	int* depth = new int[n];
+
+	std::vector<int> order(n);
+	for (int u = 0; u < n; u++) {
+		order[u] = u;
+		stamp[u] = -1;
+	}
+	std::stable_sort(order.begin(), order.end(), [g](int a, int b) {
+		return g->degree(a) < g->degree(b);
+	});
+
+	int bound = 0;
+
+	// cliques of at least three vertices, grown from low degree vertices.
+	// adjacency is tested by binary search in sorted copies of the rows, so
+	// high degree vertices are never scanned for it
+	int* sorted = new int[g->m];
+	std::copy(g->nbrs, g->nbrs + g->m, sorted);
+	for (int u = 0; u < n; u++) {
+		std::sort(sorted + g->offsets[u], sorted + g->offsets[u + 1]);
+	}
+	auto adjacent = [g, sorted](int a, int b) {
+		if (g->degree(a) > g->degree(b)) {
+			std::swap(a, b);
+		}
+		return std::binary_search(sorted + g->offsets[a], sorted + g->offsets[a + 1], b);
+	};
+
+	std::vector<int> clique;
+	for (auto it = order.begin(); it != order.end(); ++it) {
+		int u = *it;
+		if (used[u]) {
+			continue;
+		}
+
+		clique.clear();
+		clique.push_back(u);
+		for (int* iv = g->begin(u); iv != g->end(u); ++iv) {
+			int v = *iv;
+			if (used[v]) {
+				continue;
+			}
+
+			bool all = true;
+			for (size_t i = 1; i < clique.size() && all; i++) {
+				all = adjacent(v, clique[i]);
+			}
+			if (all) {
+				clique.push_back(v);
+			}
+		}
+
+		if (clique.size() >= 3) {
+			for (auto ic = clique.begin(); ic != clique.end(); ++ic) {
+				used[*ic] = 1;
+			}
+			bound += clique.size() - 1;
+		}
+	}
+	delete[] sorted;
+
+	// short odd cycles among the rest, closed by an edge between two vertices
+	// at the same depth of a bfs tree that scans at most CYCLE_LIMIT edges.
+	// vertices reached by a tree without one are not used as roots again
+	std::vector<int> queue;
+	std::vector<int> cycle;
+	for (auto it = order.begin(); it != order.end(); ++it) {
+		int r = *it;
+		if (used[r] || tried[r]) {
+			continue;
+		}
+
+		queue.clear();
+		queue.push_back(r);
+		stamp[r] = r;
+		parent[r] = -1;
+		depth[r] = 0;
+
+		bool found = false;
+		int scanned = 0;
+		for (size_t h = 0; h < queue.size() && scanned < CYCLE_LIMIT && !found; h++) {
+			int x = queue[h];
+			scanned += g->degree(x);
+			for (int* iy = g->begin(x); iy != g->end(x); ++iy) {
+				int y = *iy;
+				if (used[y]) {
+					continue;
+				}
+
+				if (stamp[y] != r) {
+					stamp[y] = r;
+					parent[y] = x;
+					depth[y] = depth[x] + 1;
+					queue.push_back(y);
+				}
+				else if (depth[y] == depth[x]) {
+					cycle.clear();
+					int a = x;
+					int b = y;
+					while (a != b) {
+						cycle.push_back(a);
+						cycle.push_back(b);
+						a = parent[a];
+						b = parent[b];
+					}
+					cycle.push_back(a);
+
+					for (auto ic = cycle.begin(); ic != cycle.end(); ++ic) {
+						used[*ic] = 1;
+					}
+					bound += (cycle.size() + 1) / 2;
+					found = true;
+					break;
+				}
+			}
+		}
+
+		if (!found) {
+			for (auto iq = queue.begin(); iq != queue.end(); ++iq) {
+				tried[*iq] = 1;
+			}
+		}
+	}
+
+	// single edges between whatever is left
+	for (int u = 0; u < n; u++) {
+		if (used[u]) {
+			continue;
+		}
+
+		for (int* iv = g->begin(u); iv != g->end(u); ++iv) {
+			if (!used[*iv]) {
+				used[u] = 1;
+				used[*iv] = 1;
+				++bound;
+				break;
+			}
+		}
+	}
+
+	delete[] used;
+	delete[] tried;
+	delete[] stamp;
+	delete[] parent;
+	delete[] depth;
+	return bound;
+}
+
+LowerBounds lower_bounds(Graph* graph) {
+	double start = wall_time();
+	CSRGraph csr(graph);
+	LowerBounds lb = lower_bounds(&csr);
+	lb.time = wall_time() - start;
+	return lb;
+}
+
+LowerBounds lower_bounds(CSRGraph* csr) {
+	LowerBounds lb;
+	double start = wall_time();
+
+	parallel_for(3, [&](int i) {
+		if (i == 0) {
+			lb.lp = lp_bound(csr);
+		}
+		else if (i == 1) {
+			lb.packing = packing_bound(csr);
+		}
+		else {
+			lb.matching = matching_bound(csr);
+		}
+	});
+
+	lb.best = std::max(lb.matching, std::max(lb.lp, lb.packing));
+	lb.time = wall_time() - start;
+	return lb;
+}
+
+int lower_bound(Graph* graph) {
+	return lower_bounds(graph).best;
+}
+
+CoverCheck verify_cover(Graph* graph, Set* cover, int threads) {
+	CoverCheck check;
+	check.uncovered = 0;
+	check.removable = new Set();
+	if (graph->size() == 0) {
+		return check;
+	}
+
+	if (threads <= 0) {
+		threads = num_threads();
+	}
+
+	// threads take contiguous ranges of the adjacency map's slots
+	int slots = graph->adjlist.max_size();
+	int chunk = (slots + threads - 1) / threads;
+	std::vector<long> uncovered(threads, 0);
+	std::vector<std::vector<int> > removable(threads);
+	parallel_for(threads, [&](int t) {
+		Map<Set>::Iterator last = graph->adjlist.begin((t + 1) * chunk);
+		for (Map<Set>::Iterator iu = graph->adjlist.begin(t * chunk); iu != last; ++iu) {
+			int u = *iu;
+			if (!cover->contains(u)) {
+				for (Set::Iterator iv = iu->value.begin(); iv != iu->value.end(); ++iv) {
+					if (u < *iv && !cover->contains(*iv)) {
+						++uncovered[t];
+					}
+				}
+				continue;
+			}
+
+			// a cover vertex is needed once one neighbor is outside the cover
+			bool needed = false;
+			for (Set::Iterator iv = iu->value.begin(); iv != iu->value.end() && !needed; ++iv) {
+				needed = !cover->contains(*iv);
+			}
+			if (!needed) {
+				removable[t].push_back(u);
+			}
+		}
+	}, threads);
+
+	for (int t = 0; t < threads; t++) {
+		check.uncovered += uncovered[t];
+		for (auto it = removable[t].begin(); it != removable[t].end(); ++it) {
+			check.removable->insert(*it);
+		}
+	}
+	return check;
+}
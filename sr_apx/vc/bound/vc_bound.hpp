@@ -0,0 +1,41 @@
+
+#ifndef VC_BOUND_H
+#define VC_BOUND_H
+
+#include "graph.hpp"
+#include "setmap.hpp"
+#include "csr.hpp"
+
+// odd cycles are searched for by bfs trees scanning at most this many edges
+#define CYCLE_LIMIT 1024
+
+// lower bounds on the size of a minimum vertex cover
+struct LowerBounds {
+	int matching;
+	int lp;
+	int packing;
+	int best;
+	double time;
+};
+
+int matching_bound(CSRGraph*);
+int lp_bound(CSRGraph*);
+int packing_bound(CSRGraph*);
+
+// computes the three bounds concurrently on one csr snapshot
+LowerBounds lower_bounds(Graph*);
+LowerBounds lower_bounds(CSRGraph*);
+int lower_bound(Graph*);
+
+// result of checking a vertex cover. each removable vertex can be dropped on
+// its own, but two adjacent ones cannot both be
+struct CoverCheck {
+	long uncovered;
+	Set* removable;
+};
+
+// counts the edges with no endpoint in the cover and finds the cover vertices
+// whose neighbors are all in it, in one parallel pass over the adjacency
+CoverCheck verify_cover(Graph*, Set*, int threads = 0);
+
+#endif
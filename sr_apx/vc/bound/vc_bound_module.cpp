@@ -0,0 +1,74 @@
+#include <Python.h>
+
+#include "vc_bound.hpp"
+#include "pygraph.hpp"
+#include "pyset.hpp"
+#include "pycall.hpp"
+
+static PyObject* vc_bound_lowerbounds(PyObject* self, PyObject* args) {
+	PyObject* g;
+	if (!PyArg_ParseTuple(args, "O", &g)) {
+		return NULL;
+	}
+
+	CSRGraph* csr = get_csr(g);
+	Graph* graph = csr == NULL ? get_graph(g) : NULL;
+	LowerBounds lb;
+	{
+		WithoutGIL nogil({g});
+		lb = csr != NULL ? lower_bounds(csr) : lower_bounds(graph);
+	}
+	return Py_BuildValue("{s:i,s:i,s:i,s:i,s:d}", "matching", lb.matching, "lp", lb.lp, "packing", lb.packing, "best", lb.best, "time", lb.time);
+}
+
+static PyObject* vc_bound_lowerbound(PyObject* self, PyObject* args) {
+	PyObject* g;
+	if (!PyArg_ParseTuple(args, "O", &g)) {
+		return NULL;
+	}
+
+	CSRGraph* csr = get_csr(g);
+	Graph* graph = csr == NULL ? get_graph(g) : NULL;
+	int bound;
+	{
+		WithoutGIL nogil({g});
+		bound = csr != NULL ? lower_bounds(csr).best : lower_bound(graph);
+	}
+	return PyLong_FromLong(bound);
+}
+
+static PyObject* vc_bound_verifycover(PyObject* self, PyObject* args) {
+	PyObject* g;
+	PyObject* c;
+	int threads = 0;
+	if (!PyArg_ParseTuple(args, "OO|i", &g, &c, &threads)) {
+		return NULL;
+	}
+
+	Graph* graph = get_graph(g);
+	CoverCheck check;
+	{
+		WithoutGIL nogil({g, c});
+		check = verify_cover(graph, ((PySet*) c)->s, threads);
+	}
+	return Py_BuildValue("lN", check.uncovered, make_PySet(check.removable, false));
+}
+
+static PyMethodDef vc_bound_methods[] = {
+	{"lower_bounds", vc_bound_lowerbounds, METH_VARARGS, "computes the matching, lp and packing lower bounds on the minimum vertex cover as a dict"},
+	{"lower_bound", vc_bound_lowerbound, METH_VARARGS, "computes the best lower bound on the minimum vertex cover"},
+	{"verify_cover", vc_bound_verifycover, METH_VARARGS, "counts the edges a cover misses and finds the cover vertices that could be removed"},
+	{NULL},
+};
+
+static struct PyModuleDef vc_bound_module = {
+	PyModuleDef_HEAD_INIT,
+	"vc_bound",
+	"Python interface for vertex cover lower bounds and cover verification",
+	-1,
+	vc_bound_methods
+};
+
+PyMODINIT_FUNC PyInit_lib_vc_bound() {
+	return PyModule_Create(&vc_bound_module);
+}
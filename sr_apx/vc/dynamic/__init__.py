@@ -0,0 +1,2 @@
+
+from .lib_vc_dynamic import DynamicCover
@@ -0,0 +1,449 @@
+
+#include "dynamic_cover.hpp"
+#include "bipartite.hpp"
+
+DynamicCover::DynamicCover(Graph* g, double s) {
+	graph = g;
+	slack = s;
+	octset = NULL;
+	color = NULL;
+	mate = NULL;
+	cached = NULL;
+	rebuild();
+}
+
+DynamicCover::~DynamicCover() {
+	delete octset;
+	delete color;
+	delete mate;
+	delete cached;
+}
+
+// recomputes the octset, coloring and matching of the whole graph
+void DynamicCover::rebuild() {
+	delete octset;
+	delete color;
+	delete mate;
+	delete cached;
+	cached = NULL;
+
+	octset = vertex_delete(graph);
+	if (octset == NULL) {
+		octset = new Set();
+	}
+
+	Set** od = verify_bipartite(graph, octset);
+	for (Set::Iterator it = od[0]->begin(); it != od[0]->end(); ++it) {
+		octset->insert(*it);
+	}
+
+	color = new Map<int>();
+	for (Set::Iterator it = od[1]->begin(); it != od[1]->end(); ++it) {
+		(*color)[*it] = 0;
+	}
+	for (Set::Iterator it = od[2]->begin(); it != od[2]->end(); ++it) {
+		(*color)[*it] = 1;
+	}
+	for (auto it = graph->begin(); it != graph->end(); ++it) {
+		add_vertex(*it);
+	}
+
+	delete od[0];
+	delete od[1];
+	delete od[2];
+	delete[] od;
+
+	// a greedy matching first, so the phases only need to fix the rest
+	mate = new Map<int>();
+	for (Map<int>::Iterator it = color->begin(); it != color->end(); ++it) {
+		int u = *it;
+		if (mate->contains(u)) {
+			continue;
+		}
+
+		Set* nbrs = graph->neighbors(u);
+		for (Set::Iterator iv = nbrs->begin(); iv != nbrs->end(); ++iv) {
+			int v = *iv;
+			if (!octset->contains(v) && !mate->contains(v) && side(v) != side(u)) {
+				(*mate)[u] = v;
+				(*mate)[v] = u;
+				break;
+			}
+		}
+	}
+	stale = true;
+	repair();
+
+	baseline = octset->size();
+}
+
+// brings the matching back to maximum after a local search gave up, by
+// searching from all free vertices of one side until no path is left
+void DynamicCover::repair() {
+	while (stale) {
+		std::vector<int> sources;
+		for (Map<int>::Iterator it = color->begin(); it != color->end(); ++it) {
+			if (it->value == 0 && !mate->contains(*it)) {
+				sources.push_back(*it);
+			}
+		}
+
+		stale = augment(sources, false) > 0;
+	}
+}
+
+int DynamicCover::side(int u) {
+	return color->find(u)->value;
+}
+
+void DynamicCover::add_vertex(int u) {
+	if (!octset->contains(u) && !color->contains(u)) {
+		(*color)[u] = 0;
+	}
+}
+
+// flips an augmenting path starting at the bipartite vertex s, if it is free
+bool DynamicCover::augment(int s) {
+	std::vector<int> sources;
+	if (!mate->contains(s)) {
+		sources.push_back(s);
+	}
+	return augment(sources, true) > 0;
+}
+
+// grows alternating bfs trees from the free bipartite vertices in sources at
+// once and flips an augmenting path in every tree that reaches a free vertex.
+// the trees are disjoint, so the paths are too. a limited search gives up
+// once it visits SEARCH_LIMIT vertices. returns the number of paths flipped
+int DynamicCover::augment(std::vector<int>& sources, bool limited) {
+	Map<int> parent;
+	Map<int> root;
+	Set used;
+	std::vector<int> queue;
+	for (auto it = sources.begin(); it != sources.end(); ++it) {
+		parent[*it] = *it;
+		root[*it] = *it;
+		queue.push_back(*it);
+	}
+
+	int count = 0;
+	for (size_t h = 0; h < queue.size(); h++) {
+		if (limited && queue.size() > SEARCH_LIMIT) {
+			stale = true;
+			break;
+		}
+
+		int x = queue[h];
+		int r = root.find(x)->value;
+		Set* nbrs = graph->neighbors(x);
+		if (used.contains(r) || nbrs == NULL) {
+			continue;
+		}
+
+		for (Set::Iterator iy = nbrs->begin(); iy != nbrs->end(); ++iy) {
+			int y = *iy;
+			if (octset->contains(y) || parent.contains(y) || side(y) == side(x)) {
+				continue;
+			}
+
+			parent[y] = x;
+			if (!mate->contains(y)) {
+				while (true) {
+					int px = parent.find(y)->value;
+					int next = px == r ? -1 : mate->find(px)->value;
+					(*mate)[px] = y;
+					(*mate)[y] = px;
+					if (px == r) {
+						break;
+					}
+					y = next;
+				}
+
+				used.insert(r);
+				++count;
+				break;
+			}
+
+			int z = mate->find(y)->value;
+			if (!parent.contains(z)) {
+				parent[z] = y;
+				root[z] = r;
+				queue.push_back(z);
+			}
+		}
+	}
+
+	return count;
+}
+
+// after inserting an edge at the matched vertex u, an augmenting path must
+// reach u by an alternating path from a free vertex on u's side, so only those
+// free vertices are searched from
+bool DynamicCover::augment_through(int u) {
+	Set seen;
+	std::vector<int> queue;
+	std::vector<int> roots;
+	seen.insert(u);
+	queue.push_back(u);
+
+	for (size_t h = 0; h < queue.size(); h++) {
+		if (queue.size() > SEARCH_LIMIT) {
+			stale = true;
+			return false;
+		}
+
+		int x = queue[h];
+		Set* nbrs = graph->neighbors(mate->find(x)->value);
+		for (Set::Iterator iw = nbrs->begin(); iw != nbrs->end(); ++iw) {
+			int w = *iw;
+			if (octset->contains(w) || seen.contains(w) || side(w) != side(x)) {
+				continue;
+			}
+
+			seen.insert(w);
+			if (mate->contains(w)) {
+				queue.push_back(w);
+			}
+			else {
+				roots.push_back(w);
+			}
+		}
+	}
+
+	return augment(roots, true) > 0;
+}
+
+// swaps the colors of the bipartite component of v when it is small and does
+// not contain u, so that an edge uv can be added without a conflict
+bool DynamicCover::flip(int v, int u) {
+	Set seen;
+	std::vector<int> queue;
+	seen.insert(v);
+	queue.push_back(v);
+
+	for (size_t h = 0; h < queue.size(); h++) {
+		Set* nbrs = graph->neighbors(queue[h]);
+		if (nbrs == NULL) {
+			continue;
+		}
+
+		for (Set::Iterator iw = nbrs->begin(); iw != nbrs->end(); ++iw) {
+			int w = *iw;
+			if (octset->contains(w) || seen.contains(w)) {
+				continue;
+			}
+
+			if (w == u || (int) queue.size() >= FLIP_LIMIT) {
+				return false;
+			}
+
+			seen.insert(w);
+			queue.push_back(w);
+		}
+	}
+
+	for (auto it = queue.begin(); it != queue.end(); ++it) {
+		(*color)[*it] = 1 - side(*it);
+	}
+	return true;
+}
+
+// moves u into the octset, repairing the matching its partner loses
+void DynamicCover::to_octset(int u) {
+	int v = mate->contains(u) ? mate->find(u)->value : -1;
+	if (v != -1) {
+		mate->erase(u);
+		mate->erase(v);
+	}
+
+	octset->insert(u);
+	color->erase(u);
+
+	if (v != -1) {
+		augment(v);
+	}
+}
+
+// returns an octset vertex to the bipartite part when its bipartite
+// neighbors all have the same color
+void DynamicCover::try_rejoin(int u) {
+	int c = -1;
+	Set* nbrs = graph->neighbors(u);
+	for (Set::Iterator iv = nbrs->begin(); iv != nbrs->end(); ++iv) {
+		if (octset->contains(*iv)) {
+			continue;
+		}
+
+		if (c == -1) {
+			c = side(*iv);
+		}
+		else if (c != side(*iv)) {
+			return;
+		}
+	}
+
+	octset->erase(u);
+	(*color)[u] = c == -1 ? 0 : 1 - c;
+	augment(u);
+}
+
+void DynamicCover::insert_edge(int u, int v) {
+	if (u == v || graph->adjacent(u, v)) {
+		return;
+	}
+
+	delete cached;
+	cached = NULL;
+
+	add_vertex(u);
+	add_vertex(v);
+
+	bool bipartite = !octset->contains(u) && !octset->contains(v);
+	if (bipartite && side(u) == side(v) && !flip(v, u) && !flip(u, v)) {
+		to_octset(graph->degree(u) >= graph->degree(v) ? u : v);
+		bipartite = false;
+	}
+
+	graph->add_edge(u, v);
+	if (!bipartite) {
+		if (octset->size() > slack * baseline + REBUILD_MIN) {
+			rebuild();
+		}
+		return;
+	}
+
+	// the matching was maximum, so it grows by at most one along a path
+	// through the new edge
+	if (!mate->contains(u)) {
+		augment(u);
+	}
+	else if (!mate->contains(v)) {
+		augment(v);
+	}
+	else {
+		augment_through(u);
+	}
+}
+
+void DynamicCover::remove_edge(int u, int v) {
+	if (!graph->adjacent(u, v)) {
+		return;
+	}
+
+	delete cached;
+	cached = NULL;
+
+	graph->remove_edge(u, v);
+
+	bool ou = octset->contains(u);
+	bool ov = octset->contains(v);
+	if (!ou && !ov && mate->contains(u) && mate->find(u)->value == v) {
+		mate->erase(u);
+		mate->erase(v);
+		if (!augment(u)) {
+			augment(v);
+		}
+	}
+
+	if (ou) {
+		try_rejoin(u);
+	}
+	if (ov) {
+		try_rejoin(v);
+	}
+}
+
+// applies the removals first, then the insertions
+void DynamicCover::apply(const EdgeBatch& inserts, const EdgeBatch& removes) {
+	for (auto it = removes.begin(); it != removes.end(); ++it) {
+		remove_edge(it->first, it->second);
+	}
+
+	for (auto it = inserts.begin(); it != inserts.end(); ++it) {
+		insert_edge(it->first, it->second);
+	}
+}
+
+// minimum cover of the bipartite part by konig's theorem, lifted greedily
+// over the octset. kept until the next update
+Set* DynamicCover::cover() {
+	repair();
+	if (cached == NULL) {
+		cached = new Set();
+
+		Set visited;
+		std::vector<int> queue;
+		for (Map<int>::Iterator it = color->begin(); it != color->end(); ++it) {
+			if (it->value == 0 && !mate->contains(*it)) {
+				visited.insert(*it);
+				queue.push_back(*it);
+			}
+		}
+
+		for (size_t h = 0; h < queue.size(); h++) {
+			Set* nbrs = graph->neighbors(queue[h]);
+			if (nbrs == NULL) {
+				continue;
+			}
+
+			for (Set::Iterator iv = nbrs->begin(); iv != nbrs->end(); ++iv) {
+				int v = *iv;
+				if (octset->contains(v) || visited.contains(v) || side(v) == 0) {
+					continue;
+				}
+
+				visited.insert(v);
+				if (mate->contains(v) && !visited.contains(mate->find(v)->value)) {
+					visited.insert(mate->find(v)->value);
+					queue.push_back(mate->find(v)->value);
+				}
+			}
+		}
+
+		for (Map<int>::Iterator it = color->begin(); it != color->end(); ++it) {
+			if (visited.contains(*it) == (it->value == 1)) {
+				cached->insert(*it);
+			}
+		}
+
+		Set processed;
+		for (Set::Iterator iu = octset->begin(); iu != octset->end(); ++iu) {
+			int u = *iu;
+			Set* nbrs = graph->neighbors(u);
+			if (nbrs != NULL) {
+				for (Set::Iterator iv = nbrs->begin(); iv != nbrs->end(); ++iv) {
+					int v = *iv;
+					if ((!octset->contains(v) || processed.contains(v)) && !cached->contains(v)) {
+						cached->insert(u);
+						break;
+					}
+				}
+			}
+
+			processed.insert(u);
+		}
+	}
+
+	Set* ret = new Set();
+	for (Set::Iterator it = cached->begin(); it != cached->end(); ++it) {
+		ret->insert(*it);
+	}
+	return ret;
+}
+
+Set* DynamicCover::oct() {
+	Set* ret = new Set();
+	for (Set::Iterator it = octset->begin(); it != octset->end(); ++it) {
+		ret->insert(*it);
+	}
+	return ret;
+}
+
+int DynamicCover::oct_size() {
+	return octset->size();
+}
+
+int DynamicCover::matching_size() {
+	repair();
+	return mate->size() / 2;
+}
@@ -0,0 +1,61 @@
+
+#ifndef DYNAMIC_COVER_H
+#define DYNAMIC_COVER_H
+
+#include <utility>
+#include <vector>
+
+#include "graph.hpp"
+#include "setmap.hpp"
+
+// conflicting edges flip the coloring of a component of at most this many vertices
+#define FLIP_LIMIT 1024
+// local augmenting path searches give up after visiting this many vertices,
+// leaving the matching to be repaired as a whole at the next query
+#define SEARCH_LIMIT 4096
+// the octset is rebuilt from scratch once it grows past this factor of its
+// size after the last rebuild, plus REBUILD_MIN vertices
+#define REBUILD_SLACK 2.0
+#define REBUILD_MIN 64
+
+typedef std::vector<std::pair<int, int> > EdgeBatch;
+
+// maintains an octset, a 2-coloring of the rest of the graph, a maximum
+// matching of the bipartite part and the lifted vertex cover while edges are
+// inserted and removed. updates are applied to the graph passed in
+class DynamicCover {
+private:
+	Graph* graph;
+	Set* octset;
+	Map<int>* color;
+	Map<int>* mate;
+	double slack;
+	int baseline;
+	Set* cached;
+	bool stale;
+
+	bool augment(int);
+	int augment(std::vector<int>&, bool);
+	bool augment_through(int);
+	bool flip(int, int);
+	int side(int);
+	void to_octset(int);
+	void try_rejoin(int);
+	void add_vertex(int);
+	void repair();
+public:
+	DynamicCover(Graph*, double slack = REBUILD_SLACK);
+	~DynamicCover();
+
+	void insert_edge(int, int);
+	void remove_edge(int, int);
+	void apply(const EdgeBatch&, const EdgeBatch&);
+	void rebuild();
+
+	Set* cover();
+	Set* oct();
+	int oct_size();
+	int matching_size();
+};
+
+#endif
@@ -0,0 +1,257 @@
+
+#include <Python.h>
+
+#include "dynamic_cover.hpp"
+#include "pygraph.hpp"
+#include "pyset.hpp"
+#include "pycall.hpp"
+
+// dynamic cover type /////////////////////////////////
+
+// readers starts the struct as in PyReadable, and is set while a method
+// works on the cover without the gil
+typedef struct {
+	PyObject_HEAD
+	int readers;
+	PyObject* graph;
+	DynamicCover* dc;
+} PyDynamicCover;
+
+static void DynamicCover_dealloc(PyDynamicCover* self) {
+	delete self->dc;
+	Py_XDECREF(self->graph);
+	Py_TYPE(self)->tp_free((PyObject*) self);
+}
+
+static PyObject* DynamicCover_new(PyTypeObject* type, PyObject* args, PyObject* kwrds) {
+	PyDynamicCover* self;
+	self = (PyDynamicCover*) type->tp_alloc(type, 0);
+	self->readers = 0;
+	self->graph = NULL;
+	self->dc = NULL;
+	return (PyObject*) self;
+}
+
+// raises instead of racing with a method running in another thread
+static bool busy(PyDynamicCover* self) {
+	if (self->readers > 0) {
+		PyErr_SetString(PyExc_RuntimeError, "DynamicCover is in use by another thread");
+		return true;
+	}
+	return false;
+}
+
+static int DynamicCover_init(PyDynamicCover* self, PyObject* args) {
+	PyObject* g;
+	double slack = REBUILD_SLACK;
+	if (!PyArg_ParseTuple(args, "O|d", &g, &slack) || busy(self) || in_use(g)) {
+		return -1;
+	}
+
+	Py_INCREF(g);
+	Py_XDECREF(self->graph);
+	self->graph = g;
+	delete self->dc;
+	self->dc = NULL;
+
+	Graph* graph = get_graph(g);
+	DynamicCover* dc;
+	{
+		WithoutGIL nogil({g, (PyObject*) self});
+		dc = new DynamicCover(graph, slack);
+	}
+	self->dc = dc;
+	return 0;
+}
+
+// the methods need the cover built by __init__, which may not have run or
+// may have failed
+static bool initialized(PyDynamicCover* self) {
+	if (self->dc == NULL) {
+		PyErr_SetString(PyExc_ValueError, "DynamicCover is not initialized");
+		return false;
+	}
+	return !busy(self);
+}
+
+// updates change the graph, which no computation may be reading
+static bool modifiable(PyDynamicCover* self) {
+	return initialized(self) && !in_use(self->graph);
+}
+
+// reads a sequence of (u, v) pairs
+static bool parse_batch(PyObject* edges, EdgeBatch& batch) {
+	PyObject* seq = PySequence_Fast(edges, "edges must be a sequence of pairs");
+	if (seq == NULL) {
+		return false;
+	}
+
+	for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(seq); i++) {
+		int u, v;
+		if (!PyArg_ParseTuple(PySequence_Fast_GET_ITEM(seq, i), "ii", &u, &v)) {
+			Py_DECREF(seq);
+			return false;
+		}
+		batch.push_back(std::make_pair(u, v));
+	}
+
+	Py_DECREF(seq);
+	return true;
+}
+
+static PyObject* DynamicCover_insertedge(PyDynamicCover* self, PyObject* args) {
+	if (!modifiable(self)) {
+		return NULL;
+	}
+
+	int u, v;
+	if (!PyArg_ParseTuple(args, "ii", &u, &v)) {
+		return NULL;
+	}
+
+	self->dc->insert_edge(u, v);
+	Py_RETURN_NONE;
+}
+
+static PyObject* DynamicCover_removeedge(PyDynamicCover* self, PyObject* args) {
+	if (!modifiable(self)) {
+		return NULL;
+	}
+
+	int u, v;
+	if (!PyArg_ParseTuple(args, "ii", &u, &v)) {
+		return NULL;
+	}
+
+	self->dc->remove_edge(u, v);
+	Py_RETURN_NONE;
+}
+
+static PyObject* DynamicCover_apply(PyDynamicCover* self, PyObject* args) {
+	if (!modifiable(self)) {
+		return NULL;
+	}
+
+	PyObject* i;
+	PyObject* r = NULL;
+	if (!PyArg_ParseTuple(args, "O|O", &i, &r)) {
+		return NULL;
+	}
+
+	EdgeBatch inserts;
+	EdgeBatch removes;
+	if (!parse_batch(i, inserts) || (r != NULL && !parse_batch(r, removes))) {
+		return NULL;
+	}
+
+	self->dc->apply(inserts, removes);
+	Py_RETURN_NONE;
+}
+
+static PyObject* DynamicCover_rebuild(PyDynamicCover* self) {
+	if (!modifiable(self)) {
+		return NULL;
+	}
+
+	{
+		WithoutGIL nogil({self->graph, (PyObject*) self});
+		self->dc->rebuild();
+	}
+	Py_RETURN_NONE;
+}
+
+static PyObject* DynamicCover_cover(PyDynamicCover* self) {
+	if (!initialized(self)) {
+		return NULL;
+	}
+
+	Set* cover;
+	{
+		WithoutGIL nogil({self->graph, (PyObject*) self});
+		cover = self->dc->cover();
+	}
+	return make_PySet(cover, false);
+}
+
+static PyObject* DynamicCover_octset(PyDynamicCover* self) {
+	if (!initialized(self)) {
+		return NULL;
+	}
+
+	return make_PySet(self->dc->oct(), false);
+}
+
+static PyObject* DynamicCover_octsize(PyDynamicCover* self) {
+	if (!initialized(self)) {
+		return NULL;
+	}
+
+	return PyLong_FromLong(self->dc->oct_size());
+}
+
+static PyObject* DynamicCover_matchingsize(PyDynamicCover* self) {
+	if (!initialized(self)) {
+		return NULL;
+	}
+
+	int size;
+	{
+		WithoutGIL nogil({self->graph, (PyObject*) self});
+		size = self->dc->matching_size();
+	}
+	return PyLong_FromLong(size);
+}
+
+static PyMethodDef DynamicCover_methods[] = {
+	{"insert_edge", (PyCFunction) DynamicCover_insertedge, METH_VARARGS, "adds an edge to the graph and repairs the cover"},
+	{"remove_edge", (PyCFunction) DynamicCover_removeedge, METH_VARARGS, "removes an edge from the graph and repairs the cover"},
+	{"apply", (PyCFunction) DynamicCover_apply, METH_VARARGS, "applies a batch of edge insertions and optionally removals, removals first"},
+	{"rebuild", (PyCFunction) DynamicCover_rebuild, METH_NOARGS, "recomputes the octset and matching from scratch"},
+	{"cover", (PyCFunction) DynamicCover_cover, METH_NOARGS, "gets the current vertex cover"},
+	{"octset", (PyCFunction) DynamicCover_octset, METH_NOARGS, "gets the current octset"},
+	{"oct_size", (PyCFunction) DynamicCover_octsize, METH_NOARGS, "gets the size of the current octset"},
+	{"matching_size", (PyCFunction) DynamicCover_matchingsize, METH_NOARGS, "gets the size of the maximum matching of the bipartite part"},
+	{NULL},
+};
+
+static PyTypeObject DynamicCover_type = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "vc_dynamic.DynamicCover",
+	.tp_basicsize = sizeof(PyDynamicCover),
+	.tp_itemsize = 0,
+	.tp_dealloc = (destructor) DynamicCover_dealloc,
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_doc = "vertex cover maintained under edge updates to a graph",
+	.tp_methods = DynamicCover_methods,
+	.tp_init = (initproc) DynamicCover_init,
+	.tp_new = DynamicCover_new,
+};
+
+static struct PyModuleDef vc_dynamic_module = {
+	PyModuleDef_HEAD_INIT,
+	"vc_dynamic",
+	"Python interface for vertex covers of changing graphs",
+	-1,
+	NULL
+};
+
+PyMODINIT_FUNC PyInit_lib_vc_dynamic() {
+	PyObject* m;
+	if (PyType_Ready(&DynamicCover_type) < 0) {
+		return NULL;
+	}
+
+	m = PyModule_Create(&vc_dynamic_module);
+	if (m == NULL) {
+		return NULL;
+	}
+
+	Py_INCREF(&DynamicCover_type);
+	if (PyModule_AddObject(m, "DynamicCover", (PyObject*) &DynamicCover_type) < 0) {
+		Py_DECREF(&DynamicCover_type);
+		Py_DECREF(m);
+		return NULL;
+	}
+
+	return m;
+}
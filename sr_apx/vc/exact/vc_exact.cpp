@@ -2,25 +2,79 @@
 #include "vc_exact.hpp"
 #include "bipartite.hpp"
 #include "matching.hpp"
+#include "cancel.hpp"
 
 #include <cstdio>
 #include <vector>
 
+typedef unsigned long long mask_t;
+
 Set* bip_exact(Graph* graph) {
-	Set* empty = new Set();
-	Set** od = verify_bipartite(graph, empty);
-	delete empty;
+	return bip_exact(graph, NULL, NULL);
+}
 
-	if (od[0]->size() > 0) {
-		printf("%s\n", "not a bipartite graph");
+// side, when given, is one side of a known bipartition (vertices outside the
+// graph are ignored, the rest of the graph forms the other side), saving the
+// coloring. matching, when given, seeds the matching and receives the final one
+Set* bip_exact(Graph* graph, Set* side, Map<int>* matching) {
+	if (cancelled()) {
+		return NULL;
+	}
+
+	Set* left;
+	Set* right;
+	if (side == NULL) {
+		Set* empty = new Set();
+		Set** od = verify_bipartite(graph, empty);
+		delete empty;
+
+		if (od[0]->size() > 0) {
+			printf("%s\n", "not a bipartite graph");
+			delete od[0];
+			delete od[1];
+			delete od[2];
+			delete[] od;
+			return NULL;
+		}
+
+		left = od[1];
+		right = od[2];
+		delete od[0];
+		delete[] od;
+	}
+	else {
+		left = new Set();
+		right = new Set();
+		for (auto it = graph->begin(); it != graph->end(); ++it) {
+			if (side->contains(*it)) {
+				left->insert(*it);
+			}
+			else {
+				right->insert(*it);
+			}
+		}
+	}
+
+	Map<int>* match = bipartite_matching(graph, left, right, matching);
+	delete right;
+	if (match == NULL) {
+		delete left;
 		return NULL;
 	}
 
-	Set* left = od[1];
-	Set* right = od[2];
-	delete[] od;
+	if (matching != NULL) {
+		std::vector<int> stale;
+		for (Map<int>::Iterator it = matching->begin(); it != matching->end(); ++it) {
+			stale.push_back(*it);
+		}
+		for (auto it = stale.begin(); it != stale.end(); ++it) {
+			matching->erase(*it);
+		}
 
-	Map<int>* match = bipartite_matching(graph, left, right);
+		for (Map<int>::Iterator it = match->begin(); it != match->end(); ++it) {
+			(*matching)[*it] = it->value;
+		}
+	}
 
 	Set* cover = new Set();
 	Set visited;
@@ -34,6 +88,7 @@ Set* bip_exact(Graph* graph) {
 			stack.push_back(u);
 		}
 	}
+	delete left;
 
 	int current;
 	while (!stack.empty()) {
@@ -63,5 +118,173 @@ Set* bip_exact(Graph* graph) {
 
 	delete match;
 
+	if (cancelled()) {
+		delete cover;
+		return NULL;
+	}
+
+	return cover;
+}
+
+// minimum cover of the graph without octset, which must leave it bipartite.
+// only the csr arrays are read, so this also runs on a mapped graph
+Set* bip_exact(CSRGraph* graph, Set* octset) {
+	if (cancelled()) {
+		return NULL;
+	}
+
+	int n = graph->n;
+	signed char* color = new signed char[n];
+	for (int u = 0; u < n; u++) {
+		color[u] = octset != NULL && octset->contains(graph->labels[u]) ? COLOR_EXCLUDED : COLOR_NONE;
+	}
+
+	if (color_bipartite(graph, color) > 0) {
+		printf("%s\n", "not a bipartite graph");
+		delete[] color;
+		return NULL;
+	}
+
+	int* mate = bipartite_matching(graph, color);
+	if (mate == NULL) {
+		delete[] color;
+		return NULL;
+	}
+
+	// konig: left vertices not reachable from a free left vertex by an
+	// alternating path, and right vertices that are
+	char* reached = new char[n]();
+	std::vector<int> queue;
+	for (int u = 0; u < n; u++) {
+		if (color[u] == COLOR_LEFT && mate[u] == -1) {
+			reached[u] = 1;
+			queue.push_back(u);
+		}
+	}
+
+	for (size_t h = 0; h < queue.size(); h++) {
+		int u = queue[h];
+		for (int* iv = graph->begin(u); iv != graph->end(u); ++iv) {
+			int v = *iv;
+			if (color[v] != COLOR_RIGHT || reached[v]) {
+				continue;
+			}
+
+			reached[v] = 1;
+			if (mate[v] != -1 && !reached[mate[v]]) {
+				reached[mate[v]] = 1;
+				queue.push_back(mate[v]);
+			}
+		}
+	}
+
+	Set* cover = new Set();
+	for (int u = 0; u < n; u++) {
+		if ((color[u] == COLOR_LEFT && !reached[u]) || (color[u] == COLOR_RIGHT && reached[u])) {
+			cover->insert(graph->labels[u]);
+		}
+	}
+
+	delete[] color;
+	delete[] mate;
+	delete[] reached;
+	return cover;
+}
+
+void small_branch(mask_t* adj, int n, mask_t alive, mask_t chosen, int size, int& best, mask_t& bestset) {
+	if (size >= best) {
+		return;
+	}
+
+	// degree-0 vertices are dropped and degree-1 vertices force their neighbor
+	int maxv = -1;
+	int maxdeg = 0;
+	int edges = 0;
+	for (int v = 0; v < n; v++) {
+		if (!(alive >> v & 1)) {
+			continue;
+		}
+
+		int degree = __builtin_popcountll(adj[v] & alive);
+		if (degree == 0) {
+			alive &= ~(1ULL << v);
+		}
+		else if (degree == 1) {
+			int w = __builtin_ctzll(adj[v] & alive);
+			chosen |= 1ULL << w;
+			alive &= ~((1ULL << v) | (1ULL << w));
+			if (++size >= best) {
+				return;
+			}
+
+			maxv = -1;
+			maxdeg = 0;
+			edges = 0;
+			v = -1;
+		}
+		else {
+			edges += degree;
+			if (degree > maxdeg) {
+				maxdeg = degree;
+				maxv = v;
+			}
+		}
+	}
+
+	if (maxv == -1) {
+		best = size;
+		bestset = chosen;
+		return;
+	}
+
+	edges /= 2;
+	if (size + (edges + maxdeg - 1) / maxdeg >= best) {
+		return;
+	}
+
+	mask_t nbrs = adj[maxv] & alive;
+	small_branch(adj, n, alive & ~(1ULL << maxv), chosen | (1ULL << maxv), size + 1, best, bestset);
+	small_branch(adj, n, alive & ~(nbrs | (1ULL << maxv)), chosen | nbrs, size + __builtin_popcountll(nbrs), best, bestset);
+}
+
+Set* small_exact(Graph* graph) {
+	int n = graph->size();
+	if (n > SMALL_EXACT_MAX) {
+		printf("%s\n", "graph too large for small_exact");
+		return NULL;
+	}
+
+	int* label = new int[n];
+	Map<int> index;
+	int i = 0;
+	for (auto iu = graph->begin(); iu != graph->end(); ++iu) {
+		label[i] = *iu;
+		index[*iu] = i;
+		++i;
+	}
+
+	mask_t* adj = new mask_t[n];
+	for (i = 0; i < n; i++) {
+		adj[i] = 0;
+		Set* nbrs = graph->neighbors(label[i]);
+		for (Set::Iterator iv = nbrs->begin(); iv != nbrs->end(); ++iv) {
+			adj[i] |= 1ULL << index[*iv];
+		}
+	}
+
+	mask_t all = n == 64 ? ~0ULL : (1ULL << n) - 1;
+	int best = n + 1;
+	mask_t bestset = all;
+	small_branch(adj, n, all, 0, 0, best, bestset);
+
+	Set* cover = new Set();
+	for (i = 0; i < n; i++) {
+		if (bestset >> i & 1) {
+			cover->insert(label[i]);
+		}
+	}
+
+	delete[] adj;
+	delete[] label;
 	return cover;
 }
@@ -3,8 +3,15 @@
 #define VC_EXACT_H
 
 #include "graph.hpp"
+#include "csr.hpp"
 #include "setmap.hpp"
 
+// largest graph accepted by small_exact
+#define SMALL_EXACT_MAX 64
+
 Set* bip_exact(Graph*);
+Set* bip_exact(Graph*, Set*, Map<int>* matching = NULL);
+Set* bip_exact(CSRGraph*, Set* octset = NULL);
+Set* small_exact(Graph*);
 
 #endif
@@ -4,20 +4,76 @@
 #include "vc_exact.hpp"
 #include "pygraph.hpp"
 #include "pyset.hpp"
+#include "pycall.hpp"
 #include "graph.hpp"
 
 static PyObject* vc_exact_bipexact(PyObject* self, PyObject* args) {
 	PyObject* g;
-	if (!PyArg_ParseTuple(args, "O", &g)) {
+	PyObject* l = Py_None;
+	PyObject* d = Py_None;
+	if (!PyArg_ParseTuple(args, "O|OO", &g, &l, &d)) {
 		return NULL;
 	}
 
-	Graph* graph = ((PyGraph*) g)->g;
-	return make_PySet(bip_exact(graph), false);
+	if (d != Py_None && !PyDict_Check(d)) {
+		PyErr_SetString(PyExc_TypeError, "matching must be a dict");
+		return NULL;
+	}
+
+	CSRGraph* csr = get_csr(g);
+	Set* cover;
+	if (csr != NULL && l == Py_None && d == Py_None) {
+		{
+			WithoutGIL nogil({g});
+			cover = bip_exact(csr);
+		}
+		return make_PySet(cover, false);
+	}
+
+	Graph* graph = get_graph(g);
+	Set* side = l == Py_None ? NULL : ((PySet*) l)->s;
+	if (d == Py_None) {
+		{
+			WithoutGIL nogil({g, l});
+			cover = bip_exact(graph, side);
+		}
+		return make_PySet(cover, false);
+	}
+
+	// the dict seeds the matching and is replaced by the final one
+	Map<int> matching;
+	PyObject* key;
+	PyObject* value;
+	Py_ssize_t pos = 0;
+	while (PyDict_Next(d, &pos, &key, &value)) {
+		long u = PyLong_AsLong(key);
+		long v = PyLong_AsLong(value);
+		if (PyErr_Occurred()) {
+			return NULL;
+		}
+		matching[u] = v;
+	}
+
+	{
+		WithoutGIL nogil({g, l});
+		cover = bip_exact(graph, side, &matching);
+	}
+	if (cover != NULL) {
+		PyDict_Clear(d);
+		for (Map<int>::Iterator it = matching.begin(); it != matching.end(); ++it) {
+			PyObject* k = PyLong_FromLong(*it);
+			PyObject* v = PyLong_FromLong(it->value);
+			PyDict_SetItem(d, k, v);
+			Py_DECREF(k);
+			Py_DECREF(v);
+		}
+	}
+
+	return make_PySet(cover, false);
 }
 
 static PyMethodDef vc_exact_methods[] = {
-	{"bip_exact", vc_exact_bipexact, METH_VARARGS, "computes a minimum vertex cover in a bipartite graph"},
+	{"bip_exact", vc_exact_bipexact, METH_VARARGS, "computes a minimum vertex cover in a bipartite graph, optionally given one side of the bipartition and a matching dict to start from and update"},
 	{NULL},
 };
 
@@ -1,2 +1,2 @@
 
-from .lib_lp_kernel import lp_kernel
+from .lib_lp_kernel import lp_kernel, lp_partition
@@ -1,48 +1,275 @@
 
+#include <vector>
+
 #include "lp_kernel.hpp"
-#include "vc_exact.hpp"
 
-Set** lp_kernel(Graph* g) {
+#define INF 0x7fffffff
+
+// hopcroft-karp on the double cover, whose left copy of u is adjacent to the
+// right copies of the neighbors of u
+struct DoubleCover {
+    CSRGraph* graph;
+    int* left;
+    int* right;
+    int* dist;
+    long* pos;
+
+    DoubleCover(CSRGraph* g) {
+        graph = g;
+        left = new int[g->n];
+        right = new int[g->n];
+        dist = new int[g->n];
+        pos = new long[g->n];
+    }
+
+    ~DoubleCover() {
+        delete[] left;
+        delete[] right;
+        delete[] dist;
+        delete[] pos;
+    }
+
+    bool augment(int r, std::vector<int>& stack) {
+        stack.clear();
+        stack.push_back(r);
+
+        while (!stack.empty()) {
+            int u = stack.back();
+            if (pos[u] == graph->offsets[u + 1]) {
+                dist[u] = INF;
+                stack.pop_back();
+                continue;
+            }
+
+            int v = graph->nbrs[pos[u]++];
+            int w = right[v];
+            if (w == -1) {
+                for (auto it = stack.begin(); it != stack.end(); ++it) {
+                    int x = *it;
+                    int y = graph->nbrs[pos[x] - 1];
+                    left[x] = y;
+                    right[y] = x;
+                }
+                return true;
+            }
+
+            if (dist[w] == dist[u] + 1) {
+                stack.push_back(w);
+            }
+        }
+
+        return false;
+    }
+
+    void match() {
+        int n = graph->n;
+        for (int u = 0; u < n; u++) {
+            left[u] = -1;
+            right[u] = -1;
+        }
+
+        // greedy start, the phases only have to fix what it missed
+        for (int u = 0; u < n; u++) {
+            for (int* iv = graph->begin(u); iv != graph->end(u); ++iv) {
+                if (right[*iv] == -1) {
+                    left[u] = *iv;
+                    right[*iv] = u;
+                    break;
+                }
+            }
+        }
+
+        std::vector<int> queue;
+        std::vector<int> stack;
+        while (true) {
+            queue.clear();
+            for (int u = 0; u < n; u++) {
+                if (left[u] == -1) {
+                    dist[u] = 0;
+                    queue.push_back(u);
+                }
+                else {
+                    dist[u] = INF;
+                }
+            }
+
+            bool found = false;
+            for (size_t h = 0; h < queue.size(); h++) {
+                int u = queue[h];
+                for (int* iv = graph->begin(u); iv != graph->end(u); ++iv) {
+                    int w = right[*iv];
+                    if (w == -1) {
+                        found = true;
+                    }
+                    else if (dist[w] == INF) {
+                        dist[w] = dist[u] + 1;
+                        queue.push_back(w);
+                    }
+                }
+            }
+
+            if (!found) {
+                break;
+            }
+
+            for (int u = 0; u < n; u++) {
+                pos[u] = graph->offsets[u];
+            }
+            for (int u = 0; u < n; u++) {
+                if (left[u] == -1) {
+                    augment(u, stack);
+                }
+            }
+        }
+    }
+
+    // konig's cover: left copies not reachable from a free left copy by an
+    // alternating path and right copies that are. a vertex gets the lp value
+    // of half the number of its copies in the cover
+    void values(char* value) {
+        int n = graph->n;
+        char* reachleft = new char[n]();
+        char* reachright = new char[n]();
+
+        std::vector<int> queue;
+        for (int u = 0; u < n; u++) {
+            if (left[u] == -1) {
+                reachleft[u] = 1;
+                queue.push_back(u);
+            }
+        }
+
+        for (size_t h = 0; h < queue.size(); h++) {
+            int u = queue[h];
+            for (int* iv = graph->begin(u); iv != graph->end(u); ++iv) {
+                int v = *iv;
+                if (reachright[v]) {
+                    continue;
+                }
+
+                reachright[v] = 1;
+                int w = right[v];
+                if (w != -1 && !reachleft[w]) {
+                    reachleft[w] = 1;
+                    queue.push_back(w);
+                }
+            }
+        }
 
-    int n = g->size();
-    Graph* h = new Graph();
-    Set* left = new Set();
-    Set* right = new Set();
+        for (int u = 0; u < n; u++) {
+            value[u] = !reachleft[u] + reachright[u];
+        }
+
+        delete[] reachleft;
+        delete[] reachright;
+    }
+};
+
+LPKernel::LPKernel(Graph* g) : LPKernel(new CSRGraph(g)) {
+    owned = true;
+}
+
+// works on a csr snapshot owned by the caller
+LPKernel::LPKernel(CSRGraph* g) {
+    graph = g;
+    owned = false;
+    value = new char[graph->n];
 
-    for (auto iu = g->begin(); iu != g->end(); ++iu) {
-        int u = *iu;
+    DoubleCover dc(graph);
+    dc.match();
+    dc.values(value);
+
+    kernel_size = 0;
+    kernel_edges = 0;
+    for (int u = 0; u < graph->n; u++) {
+        if (contains(u)) {
+            ++kernel_size;
+            kernel_edges += degree(u);
+        }
+    }
+    kernel_edges /= 2;
+}
+
+LPKernel::~LPKernel() {
+    if (owned) {
+        delete graph;
+    }
+    delete[] value;
+}
+
+int LPKernel::degree(int u) {
+    int d = 0;
+    for (int* iv = graph->begin(u); iv != graph->end(u); ++iv) {
+        if (contains(*iv)) {
+            ++d;
+        }
+    }
+    return d;
+}
 
-        left->insert(u);
-        right->insert(u + n);
+// the lp optimum rounded up, a lower bound on the minimum cover
+int LPKernel::bound() {
+    int in = 0;
+    for (int u = 0; u < graph->n; u++) {
+        if (value[u] == LP_IN) {
+            ++in;
+        }
+    }
+    return in + (kernel_size + 1) / 2;
+}
 
-        for (auto inbr = g->neighbors(u)->begin(); inbr != g->neighbors(u)->end(); ++inbr) {
-            int nbr = *inbr;
-            h->add_edge(u, nbr + 2 * n);
+Set* LPKernel::in() {
+    Set* s = new Set();
+    for (int u = 0; u < graph->n; u++) {
+        if (value[u] == LP_IN) {
+            s->insert(graph->labels[u]);
         }
     }
+    return s;
+}
 
-    Set* cover = bip_exact(h);
+Set* LPKernel::out() {
+    Set* s = new Set();
+    for (int u = 0; u < graph->n; u++) {
+        if (value[u] == LP_OUT) {
+            s->insert(graph->labels[u]);
+        }
+    }
+    return s;
+}
 
-    Set* in = new Set();
-    Set* out = new Set();
+Set* LPKernel::kernel() {
+    Set* s = new Set();
+    for (int u = 0; u < graph->n; u++) {
+        if (contains(u)) {
+            s->insert(graph->labels[u]);
+        }
+    }
+    return s;
+}
 
-    for (auto iu = g->begin(); iu != g->end(); ++iu) {
-        int u = *iu;
-        if (cover->contains(u) && cover->contains(u + 2 * n)) {
-            in->insert(u);
+// copies the kernel out of the view, for algorithms that need a Graph
+Graph* LPKernel::subgraph() {
+    Graph* h = new Graph(kernel_size);
+    for (int u = 0; u < graph->n; u++) {
+        if (!contains(u)) {
+            continue;
         }
-        else if (!cover->contains(u) && !cover->contains(u + 2 * n)) {
-            out->insert(u);
+
+        for (int* iv = graph->begin(u); iv != graph->end(u); ++iv) {
+            if (*iv > u && contains(*iv)) {
+                h->add_edge(graph->labels[u], graph->labels[*iv]);
+            }
         }
     }
+    return h;
+}
 
-    delete h;
-    delete left;
-    delete right;
-    delete cover;
+Set** lp_kernel(Graph* g) {
+    LPKernel k(g);
 
     Set** ret = new Set*[2];
-    ret[0] = in;
-    ret[1] = out;
+    ret[0] = k.in();
+    ret[1] = k.out();
     return ret;
 }
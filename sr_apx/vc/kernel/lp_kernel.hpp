@@ -4,6 +4,39 @@
 
 #include "setmap.hpp"
 #include "graph.hpp"
+#include "csr.hpp"
+
+#define LP_OUT 0
+#define LP_HALF 1
+#define LP_IN 2
+
+// half-integral optimum of the vertex cover lp (nemhauser-trotter), found by
+// a maximum matching of the bipartite double cover of the graph. the double
+// cover is never built: both copies of a vertex share its csr row
+class LPKernel {
+public:
+    CSRGraph* graph;
+    bool owned;
+    char* value;
+    int kernel_size;
+    long kernel_edges;
+
+    LPKernel(Graph*);
+    LPKernel(CSRGraph*);
+    ~LPKernel();
+
+    Set* in();
+    Set* out();
+    Set* kernel();
+
+    // the kernel as a view of graph: a csr vertex belongs to it when
+    // contains() holds, and its kernel neighbors are the ones in
+    // graph->begin(u)..graph->end(u) that belong to it too
+    bool contains(int u) {return value[u] == LP_HALF;};
+    int degree(int);
+    int bound();
+    Graph* subgraph();
+};
 
 Set** lp_kernel(Graph*);
 
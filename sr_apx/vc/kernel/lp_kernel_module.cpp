@@ -4,6 +4,7 @@
 #include "lp_kernel.hpp"
 #include "pygraph.hpp"
 #include "pyset.hpp"
+#include "pycall.hpp"
 #include "graph.hpp"
 
 static PyObject* vc_kernel_lpkernel(PyObject* self, PyObject* args) {
@@ -12,17 +13,41 @@ static PyObject* vc_kernel_lpkernel(PyObject* self, PyObject* args) {
         return NULL;
     }
 
-    Graph* graph = ((PyGraph*) g)->g;
+    Graph* graph = get_graph(g);
 
-    Set** kernel = lp_kernel(graph);
+    Set** kernel;
+    {
+        WithoutGIL nogil({g});
+        kernel = lp_kernel(graph);
+    }
     PyObject* in = make_PySet(kernel[0], false);
     PyObject* out = make_PySet(kernel[1], false);
     delete[] kernel;
     return Py_BuildValue("OO", in, out);
 }
 
+static PyObject* vc_kernel_lppartition(PyObject* self, PyObject* args) {
+    PyObject* g;
+    if (!PyArg_ParseTuple(args, "O", &g)) {
+        return NULL;
+    }
+
+    // an attached graph is partitioned in place, without building it
+    CSRGraph* csr = get_csr(g);
+    Graph* graph = csr == NULL ? get_graph(g) : NULL;
+    LPKernel* k;
+    {
+        WithoutGIL nogil({g});
+        k = csr != NULL ? new LPKernel(csr) : new LPKernel(graph);
+    }
+    PyObject* ret = Py_BuildValue("NNN", make_PySet(k->in(), false), make_PySet(k->out(), false), make_PySet(k->kernel(), false));
+    delete k;
+    return ret;
+}
+
 static PyMethodDef lp_kernel_methods[] = {
     {"lp_kernel", vc_kernel_lpkernel, METH_VARARGS, "computes a kernel for a bipartite graph using lp flow kernelization"},
+    {"lp_partition", vc_kernel_lppartition, METH_VARARGS, "splits the vertices into those in some minimum cover, those in none and the kernel"},
     {NULL},
 };
 
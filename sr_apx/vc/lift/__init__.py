@@ -1,2 +1,2 @@
 
-from .lib_vc_lift import naive_lift, greedy_lift, apx_lift, oct_lift, bip_lift, recursive_lift, recursive_oct_lift, recursive_bip_lift
+from .lib_vc_lift import naive_lift, greedy_lift, apx_lift, oct_lift, bip_lift, recursive_lift, recursive_oct_lift, recursive_bip_lift, recursive_k_lift, recursive_oct_k_lift, recursive_cover, lift_all, portfolio_lift
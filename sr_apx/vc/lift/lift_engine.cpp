@@ -0,0 +1,263 @@
+
+#include "lift_engine.hpp"
+#include "vc_lift.hpp"
+#include "vc_apx.hpp"
+#include "vc_exact.hpp"
+#include "bipartite.hpp"
+#include "util.hpp"
+
+const char* lift_names[NUM_LIFTS] = {"naive", "greedy", "apx", "oct", "bip", "recursive", "recursive_oct", "recursive_bip"};
+
+static void insert_all(Set* into, Set* from) {
+	for (Set::Iterator it = from->begin(); it != from->end(); ++it) {
+		into->insert(*it);
+	}
+}
+
+// covers a graph by vertex_delete followed by bip_exact on the remainder
+static Set* split_cover(Graph* h) {
+	Set* octset = vertex_delete(h);
+	if (octset == NULL) {
+		return NULL;
+	}
+
+	Set* subgraph_vertices = new Set();
+	for (auto it = h->begin(); it != h->end(); ++it) {
+		if (!octset->contains(*it)) {
+			subgraph_vertices->insert(*it);
+		}
+	}
+
+	Graph* g = h->subgraph(subgraph_vertices);
+	delete subgraph_vertices;
+	if (g == NULL) {
+		delete octset;
+		return NULL;
+	}
+
+	Set* cover = bip_exact(g);
+	delete g;
+	if (cover != NULL) {
+		insert_all(cover, octset);
+	}
+
+	delete octset;
+	return cover;
+}
+
+LiftEngine::LiftEngine(Graph* g, Set* o, Set* p) {
+	graph = g;
+	octset = o;
+	partial = p;
+	octgraph = NULL;
+	residual = NULL;
+	bridgecover = NULL;
+	bridgematch = NULL;
+	octrest = NULL;
+}
+
+LiftEngine::~LiftEngine() {
+	delete octgraph;
+	delete residual;
+	delete bridgecover;
+	delete bridgematch;
+	delete octrest;
+}
+
+// G[octset], shared by oct and recursive_oct. the graphs are NULL, and not
+// cached, when the copy is cancelled
+Graph* LiftEngine::oct_graph() {
+	if (octgraph == NULL) {
+		octgraph = graph->subgraph(octset);
+	}
+	return octgraph;
+}
+
+// the graph left after removing partial, shared by apx and recursive
+Graph* LiftEngine::residual_graph() {
+	if (residual == NULL) {
+		Set* subgraph_vertices = new Set();
+		for (auto it = graph->begin(); it != graph->end(); ++it) {
+			if (octset->contains(*it) || !partial->contains(*it)) {
+				subgraph_vertices->insert(*it);
+			}
+		}
+
+		residual = graph->subgraph(subgraph_vertices);
+		delete subgraph_vertices;
+	}
+	return residual;
+}
+
+// minimum cover of the edges between the octset and the uncovered bipartite
+// vertices, shared by bip and recursive_bip
+Set* LiftEngine::bridge_cover() {
+	if (bridgecover == NULL) {
+		Graph* h = new Graph();
+		for (Set::Iterator iu = octset->begin(); iu != octset->end(); ++iu) {
+			int u = *iu;
+			Set* nbrs = graph->neighbors(u);
+			if (nbrs == NULL) {
+				continue;
+			}
+
+			for (Set::Iterator iv = nbrs->begin(); iv != nbrs->end(); ++iv) {
+				int v = *iv;
+				if (!octset->contains(v) && !partial->contains(v)) {
+					h->add_edge(u, v);
+				}
+			}
+		}
+
+		bridgematch = new Map<int>();
+		bridgecover = bip_exact(h, octset, bridgematch);
+		delete h;
+
+		// a cancelled cover is computed again by the next call, with a new
+		// matching, and this one is not a warm start for rest_cover
+		if (bridgecover == NULL) {
+			delete bridgematch;
+			bridgematch = NULL;
+		}
+	}
+	return bridgecover;
+}
+
+// octset vertices not taken by the bridge cover, shared by bip and recursive_bip
+Graph* LiftEngine::oct_rest() {
+	if (octrest == NULL) {
+		Set* cover = bridge_cover();
+		if (cover == NULL) {
+			return NULL;
+		}
+
+		Set* subgraph_vertices = new Set();
+		for (Set::Iterator it = octset->begin(); it != octset->end(); ++it) {
+			if (!cover->contains(*it)) {
+				subgraph_vertices->insert(*it);
+			}
+		}
+
+		octrest = graph->subgraph(subgraph_vertices);
+		delete subgraph_vertices;
+	}
+	return octrest;
+}
+
+// completes a cover of the octset side with partial and an exact cover of
+// the bipartite graph left uncovered
+Set* LiftEngine::rest_cover(Set* cover) {
+	if (cover == NULL) {
+		return NULL;
+	}
+
+	insert_all(cover, partial);
+
+	Set* subgraph_vertices = new Set();
+	for (auto it = graph->begin(); it != graph->end(); ++it) {
+		if (!cover->contains(*it)) {
+			subgraph_vertices->insert(*it);
+		}
+	}
+
+	// the remaining graph has the octset on one side, and its edges are bridge
+	// edges, so a cached bridge matching is a warm start
+	Map<int> warm;
+	if (bridgematch != NULL) {
+		for (Map<int>::Iterator it = bridgematch->begin(); it != bridgematch->end(); ++it) {
+			warm[*it] = it->value;
+		}
+	}
+
+	Graph* h = graph->subgraph(subgraph_vertices);
+	delete subgraph_vertices;
+	if (h == NULL) {
+		delete cover;
+		return NULL;
+	}
+
+	Set* bipcover = bip_exact(h, octset, &warm);
+	delete h;
+	if (bipcover == NULL) {
+		delete cover;
+		return NULL;
+	}
+
+	insert_all(cover, bipcover);
+	delete bipcover;
+	return cover;
+}
+
+// adds the cached covers in extra to cover, freeing cover if one is missing
+static Set* complete(Set* cover, Set* extra, Set* partial) {
+	if (cover == NULL || extra == NULL) {
+		delete cover;
+		return NULL;
+	}
+
+	insert_all(cover, extra);
+	insert_all(cover, partial);
+	return cover;
+}
+
+Set* LiftEngine::lift(const std::string& name) {
+	if (name == "naive") {
+		return naive_lift(graph, octset, partial);
+	}
+	else if (name == "greedy") {
+		return greedy_lift(graph, octset, partial);
+	}
+	else if (name == "apx") {
+		Graph* h = residual_graph();
+		Set* cover = h == NULL ? NULL : std_apx(h);
+		if (cover != NULL) {
+			insert_all(cover, partial);
+		}
+		return cover;
+	}
+	else if (name == "oct") {
+		Graph* h = oct_graph();
+		return rest_cover(h == NULL ? NULL : std_apx(h));
+	}
+	else if (name == "bip") {
+		Graph* h = oct_rest();
+		Set* cover = h == NULL ? NULL : std_apx(h);
+		return complete(cover, bridge_cover(), partial);
+	}
+	else if (name == "recursive") {
+		Graph* h = residual_graph();
+		Set* cover = h == NULL ? NULL : split_cover(h);
+		if (cover != NULL) {
+			insert_all(cover, partial);
+		}
+		return cover;
+	}
+	else if (name == "recursive_oct") {
+		Graph* h = oct_graph();
+		return rest_cover(h == NULL ? NULL : split_cover(h));
+	}
+	else if (name == "recursive_bip") {
+		Graph* h = oct_rest();
+		Set* cover = h == NULL ? NULL : split_cover(h);
+		return complete(cover, bridge_cover(), partial);
+	}
+
+	return NULL;
+}
+
+LiftResult LiftEngine::run(const std::string& name) {
+	LiftResult result;
+	result.name = name;
+	double start = wall_time();
+	result.cover = lift(name);
+	result.time = wall_time() - start;
+	return result;
+}
+
+std::vector<LiftResult> LiftEngine::run(const std::vector<std::string>& names) {
+	std::vector<LiftResult> results;
+	for (auto it = names.begin(); it != names.end(); ++it) {
+		results.push_back(run(*it));
+	}
+	return results;
+}
@@ -0,0 +1,50 @@
+
+#ifndef LIFT_ENGINE_H
+#define LIFT_ENGINE_H
+
+#include <string>
+#include <vector>
+
+#include "graph.hpp"
+#include "setmap.hpp"
+
+#define NUM_LIFTS 8
+
+// names accepted by LiftEngine, in the order main reports them
+extern const char* lift_names[NUM_LIFTS];
+
+struct LiftResult {
+	std::string name;
+	Set* cover;
+	double time;
+};
+
+// evaluates lift strategies for one (graph, octset, partial) triple, computing
+// each intermediate they share at most once
+class LiftEngine {
+private:
+	Graph* graph;
+	Set* octset;
+	Set* partial;
+
+	Graph* octgraph;
+	Graph* residual;
+	Set* bridgecover;
+	Map<int>* bridgematch;
+	Graph* octrest;
+
+	Graph* oct_graph();
+	Graph* residual_graph();
+	Set* bridge_cover();
+	Graph* oct_rest();
+	Set* rest_cover(Set*);
+public:
+	LiftEngine(Graph*, Set*, Set*);
+	~LiftEngine();
+
+	Set* lift(const std::string&);
+	LiftResult run(const std::string&);
+	std::vector<LiftResult> run(const std::vector<std::string>&);
+};
+
+#endif
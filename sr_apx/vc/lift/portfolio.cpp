@@ -0,0 +1,90 @@
+
+#include "portfolio.hpp"
+#include "lift_engine.hpp"
+#include "vc_lift.hpp"
+#include "cancel.hpp"
+#include "util.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// in the order of lift_names
+static Set* (*lift_functions[NUM_LIFTS])(Graph*, Set*, Set*) = {
+	naive_lift, greedy_lift, apx_lift, oct_lift, bip_lift, recursive_lift, recursive_oct_lift, recursive_bip_lift
+};
+
+// runs every lift on its own thread and returns the smallest cover found
+// within seconds (no limit if not positive). remaining lifts are cancelled at
+// the deadline or as soon as a cover reaches lowerbound
+PortfolioResult portfolio_lift(Graph* graph, Set* octset, Set* partial, double seconds, int lowerbound) {
+	std::atomic<bool> stop(false);
+	std::mutex lock;
+	std::condition_variable done;
+	int finished = 0;
+
+	PortfolioResult best;
+	best.cover = NULL;
+	best.time = 0;
+	best.bound_met = false;
+
+	double start = wall_time();
+	std::vector<std::thread> threads;
+	for (int l = 0; l < NUM_LIFTS; l++) {
+		threads.push_back(std::thread([&, l]() {
+			Set* cover;
+			{
+				CancelScope scope(&stop);
+				cover = lift_functions[l](graph, octset, partial);
+			}
+			double time = wall_time() - start;
+
+			// a lift that only stops after the deadline does not compete
+			std::lock_guard<std::mutex> guard(lock);
+			++finished;
+			bool late = seconds > 0 && time > seconds;
+			if (cover != NULL && !late && (best.cover == NULL || cover->size() < best.cover->size())) {
+				delete best.cover;
+				best.cover = cover;
+				best.strategy = lift_names[l];
+				best.time = time;
+				if (cover->size() <= lowerbound) {
+					best.bound_met = true;
+					stop = true;
+				}
+			}
+			else {
+				delete cover;
+			}
+			done.notify_all();
+		}));
+	}
+
+	// the wait also ends when the calling thread is cancelled, which it polls
+	// for every few milliseconds
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		auto ready = [&]() {return finished == NUM_LIFTS || stop;};
+		double deadline = start + seconds;
+		while (!ready() && !cancelled()) {
+			double slice = 0.01;
+			if (seconds > 0) {
+				slice = std::min(slice, deadline - wall_time());
+				if (slice <= 0) {
+					break;
+				}
+			}
+			done.wait_for(guard, std::chrono::duration<double>(slice), ready);
+		}
+		stop = true;
+	}
+
+	for (auto it = threads.begin(); it != threads.end(); ++it) {
+		it->join();
+	}
+
+	return best;
+}
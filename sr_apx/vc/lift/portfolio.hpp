@@ -0,0 +1,19 @@
+
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include <string>
+
+#include "graph.hpp"
+#include "setmap.hpp"
+
+struct PortfolioResult {
+	Set* cover;
+	std::string strategy;
+	double time;
+	bool bound_met;
+};
+
+PortfolioResult portfolio_lift(Graph*, Set*, Set*, double, int lowerbound = 0);
+
+#endif
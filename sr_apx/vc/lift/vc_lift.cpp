@@ -3,6 +3,7 @@
 #include "vc_apx.hpp"
 #include "vc_exact.hpp"
 #include "bipartite.hpp"
+#include "cancel.hpp"
 
 Set* naive_lift(Graph* graph, Set* octset, Set* partial) {
 	Set* cover = new Set();
@@ -34,7 +35,13 @@ Set* greedy_lift(Graph* graph, Set* octset, Set* partial) {
 		}
 	}
 
+	int steps = 0;
 	for (Set::Iterator iu = octset->begin(); iu != octset->end(); ++iu) {
+		if ((++steps & 1023) == 0 && cancelled()) {
+			delete cover;
+			return NULL;
+		}
+
 		int u = *iu;
 		for (Set::Iterator iv = graph->neighbors(u)->begin(); iv != graph->neighbors(u)->end(); ++iv) {
 			int v = *iv;
@@ -60,25 +67,39 @@ Set* apx_lift(Graph* graph, Set* octset, Set* partial) {
 
 	Graph* h = graph->subgraph(subgraph_vertices);
 	delete subgraph_vertices;
+	if (h == NULL) {
+		return NULL;
+	}
 
 	Set* cover = std_apx(h);
+	delete h;
+	if (cover == NULL) {
+		return NULL;
+	}
+
 	for (Set::Iterator it = partial->begin(); it != partial->end(); ++it) {
 		cover->insert(*it);
 	}
 
-	delete h;
 	return cover;
 }
 
 Set* oct_lift(Graph* graph, Set* octset, Set* partial) {
 	Graph* h = graph->subgraph(octset);
+	if (h == NULL) {
+		return NULL;
+	}
+
 	Set* cover = std_apx(h);
+	delete h;
+	if (cover == NULL) {
+		return NULL;
+	}
+
 	for (Set::Iterator it = partial->begin(); it != partial->end(); ++it) {
 		cover->insert(*it);
 	}
 
-	delete h;
-
 	Set* subgraph_vertices = new Set();
 	for (auto it = graph->begin(); it != graph->end(); ++it) {
 		if (!cover->contains(*it)) {
@@ -87,13 +108,23 @@ Set* oct_lift(Graph* graph, Set* octset, Set* partial) {
 	}
 
 	h = graph->subgraph(subgraph_vertices);
-	Set* bipcover = bip_exact(h);
+	delete subgraph_vertices;
+	if (h == NULL) {
+		delete cover;
+		return NULL;
+	}
+
+	Set* bipcover = bip_exact(h, octset);
+	delete h;
+	if (bipcover == NULL) {
+		delete cover;
+		return NULL;
+	}
+
 	for (Set::Iterator it = bipcover->begin(); it != bipcover->end(); ++it) {
 		cover->insert(*it);
 	}
 
-	delete h;
-	delete subgraph_vertices;
 	delete bipcover;
 
 	return cover;
@@ -101,7 +132,13 @@ Set* oct_lift(Graph* graph, Set* octset, Set* partial) {
 
 Set* bip_lift(Graph* graph, Set* octset, Set* partial) {
 	Graph* h = new Graph();
+	int steps = 0;
 	for (auto iu = graph->begin(); iu != graph->end(); ++iu) {
+		if ((++steps & 1023) == 0 && cancelled()) {
+			delete h;
+			return NULL;
+		}
+
 		int u = *iu;
 		if (!octset->contains(u)) {
 			continue;
@@ -116,8 +153,11 @@ Set* bip_lift(Graph* graph, Set* octset, Set* partial) {
 		}
 	}
 
-	Set* cover = bip_exact(h);
+	Set* cover = bip_exact(h, octset);
 	delete h;
+	if (cover == NULL) {
+		return NULL;
+	}
 
 	Set* subgraph_vertices = new Set();
 	for (Set::Iterator it = octset->begin(); it != octset->end(); ++it) {
@@ -128,8 +168,17 @@ Set* bip_lift(Graph* graph, Set* octset, Set* partial) {
 
 	h = graph->subgraph(subgraph_vertices);
 	delete subgraph_vertices;
+	if (h == NULL) {
+		delete cover;
+		return NULL;
+	}
+
 	Set* octcover = std_apx(h);
 	delete h;
+	if (octcover == NULL) {
+		delete cover;
+		return NULL;
+	}
 
 	for (Set::Iterator it = partial->begin(); it != partial->end(); ++it) {
 		cover->insert(*it);
@@ -154,8 +203,16 @@ Set* recursive_lift(Graph* graph, Set* octset, Set* partial) {
 
 	Graph* h = graph->subgraph(subgraph_vertices);
 	delete subgraph_vertices;
+	if (h == NULL) {
+		return NULL;
+	}
 
 	Set* octset2 = vertex_delete(h);
+	if (octset2 == NULL) {
+		delete h;
+		return NULL;
+	}
+
 	subgraph_vertices = new Set();
 	for (auto it = h->begin(); it != h->end(); ++it) {
 		if (!octset2->contains(*it)) {
@@ -166,7 +223,17 @@ Set* recursive_lift(Graph* graph, Set* octset, Set* partial) {
 	Graph* g = h->subgraph(subgraph_vertices);
 	delete h;
 	delete subgraph_vertices;
+	if (g == NULL) {
+		delete octset2;
+		return NULL;
+	}
+
 	Set* cover = bip_exact(g);
+	delete g;
+	if (cover == NULL) {
+		delete octset2;
+		return NULL;
+	}
 
 	for (Set::Iterator it = partial->begin(); it != partial->end(); ++it) {
 		cover->insert(*it);
@@ -177,14 +244,22 @@ Set* recursive_lift(Graph* graph, Set* octset, Set* partial) {
 	}
 
 	delete octset2;
-	delete g;
 
 	return cover;
 }
 
 Set* recursive_oct_lift(Graph* graph, Set* octset, Set* partial) {
 	Graph* h = graph->subgraph(octset);
+	if (h == NULL) {
+		return NULL;
+	}
+
 	Set* octset2 = vertex_delete(h);
+	if (octset2 == NULL) {
+		delete h;
+		return NULL;
+	}
+
 	Set* subgraph_vertices = new Set();
 	for (auto it = h->begin(); it != h->end(); ++it) {
 		if (!octset2->contains(*it)) {
@@ -195,8 +270,17 @@ Set* recursive_oct_lift(Graph* graph, Set* octset, Set* partial) {
 	Graph* g = h->subgraph(subgraph_vertices);
 	delete h;
 	delete subgraph_vertices;
+	if (g == NULL) {
+		delete octset2;
+		return NULL;
+	}
+
 	Set* cover = bip_exact(g);
 	delete g;
+	if (cover == NULL) {
+		delete octset2;
+		return NULL;
+	}
 
 	for (Set::Iterator it = octset2->begin(); it != octset2->end(); ++it) {
 		cover->insert(*it);
@@ -217,8 +301,17 @@ Set* recursive_oct_lift(Graph* graph, Set* octset, Set* partial) {
 
 	g = graph->subgraph(subgraph_vertices);
 	delete subgraph_vertices;
-	Set* bipcover = bip_exact(g);
+	if (g == NULL) {
+		delete cover;
+		return NULL;
+	}
+
+	Set* bipcover = bip_exact(g, octset);
 	delete g;
+	if (bipcover == NULL) {
+		delete cover;
+		return NULL;
+	}
 
 	for (Set::Iterator it = bipcover->begin(); it != bipcover->end(); ++it) {
 		cover->insert(*it);
@@ -231,7 +324,13 @@ Set* recursive_oct_lift(Graph* graph, Set* octset, Set* partial) {
 
 Set* recursive_bip_lift(Graph* graph, Set* octset, Set* partial) {
 	Graph* h = new Graph();
+	int steps = 0;
 	for (auto iu = graph->begin(); iu != graph->end(); ++iu) {
+		if ((++steps & 1023) == 0 && cancelled()) {
+			delete h;
+			return NULL;
+		}
+
 		int u = *iu;
 		if (!octset->contains(u)) {
 			continue;
@@ -246,8 +345,11 @@ Set* recursive_bip_lift(Graph* graph, Set* octset, Set* partial) {
 		}
 	}
 
-	Set* cover = bip_exact(h);
+	Set* cover = bip_exact(h, octset);
 	delete h;
+	if (cover == NULL) {
+		return NULL;
+	}
 
 	Set* subgraph_vertices = new Set();
 	for (Set::Iterator it = octset->begin(); it != octset->end(); ++it) {
@@ -258,8 +360,18 @@ Set* recursive_bip_lift(Graph* graph, Set* octset, Set* partial) {
 
 	h = graph->subgraph(subgraph_vertices);
 	delete subgraph_vertices;
+	if (h == NULL) {
+		delete cover;
+		return NULL;
+	}
 
 	Set* octset2 = vertex_delete(h);
+	if (octset2 == NULL) {
+		delete h;
+		delete cover;
+		return NULL;
+	}
+
 	subgraph_vertices = new Set();
 	for (auto it = h->begin(); it != h->end(); ++it) {
 		if (!octset2->contains(*it)) {
@@ -270,8 +382,19 @@ Set* recursive_bip_lift(Graph* graph, Set* octset, Set* partial) {
 	Graph* g = h->subgraph(subgraph_vertices);
 	delete subgraph_vertices;
 	delete h;
+	if (g == NULL) {
+		delete octset2;
+		delete cover;
+		return NULL;
+	}
+
 	Set* octcover = bip_exact(g);
 	delete g;
+	if (octcover == NULL) {
+		delete octset2;
+		delete cover;
+		return NULL;
+	}
 
 	for (Set::Iterator it = octcover->begin(); it != octcover->end(); ++it) {
 		cover->insert(*it);
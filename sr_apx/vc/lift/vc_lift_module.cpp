@@ -1,9 +1,15 @@
 
 #include <Python.h>
 
+#include <algorithm>
+
 #include "vc_lift.hpp"
+#include "lift_engine.hpp"
+#include "portfolio.hpp"
+#include "vc_recursive.hpp"
 #include "pygraph.hpp"
 #include "pyset.hpp"
+#include "pycall.hpp"
 
 static PyObject* vc_lift_naivelift(PyObject* self, PyObject* args) {
 	PyObject* g;
@@ -14,11 +20,16 @@ static PyObject* vc_lift_naivelift(PyObject* self, PyObject* args) {
 		return NULL;
 	}
 
-	Graph* graph = ((PyGraph*) g)->g;
+	Graph* graph = get_graph(g);
 	Set* octset = ((PySet*) o)->s;
 	Set* partial = ((PySet*) p)->s;
 
-	return make_PySet(naive_lift(graph, octset, partial), false);
+	Set* cover;
+	{
+		WithoutGIL nogil({g, o, p});
+		cover = naive_lift(graph, octset, partial);
+	}
+	return make_PySet(cover, false);
 }
 
 static PyObject* vc_lift_greedylift(PyObject* self, PyObject* args) {
@@ -30,11 +41,16 @@ static PyObject* vc_lift_greedylift(PyObject* self, PyObject* args) {
 		return NULL;
 	}
 
-	Graph* graph = ((PyGraph*) g)->g;
+	Graph* graph = get_graph(g);
 	Set* octset = ((PySet*) o)->s;
 	Set* partial = ((PySet*) p)->s;
 
-	return make_PySet(greedy_lift(graph, octset, partial), false);
+	Set* cover;
+	{
+		WithoutGIL nogil({g, o, p});
+		cover = greedy_lift(graph, octset, partial);
+	}
+	return make_PySet(cover, false);
 }
 
 static PyObject* vc_lift_apxlift(PyObject* self, PyObject* args) {
@@ -46,11 +62,16 @@ static PyObject* vc_lift_apxlift(PyObject* self, PyObject* args) {
 		return NULL;
 	}
 
-	Graph* graph = ((PyGraph*) g)->g;
+	Graph* graph = get_graph(g);
 	Set* octset = ((PySet*) o)->s;
 	Set* partial = ((PySet*) p)->s;
 
-	return make_PySet(apx_lift(graph, octset, partial), false);
+	Set* cover;
+	{
+		WithoutGIL nogil({g, o, p});
+		cover = apx_lift(graph, octset, partial);
+	}
+	return make_PySet(cover, false);
 }
 
 static PyObject* vc_lift_octlift(PyObject* self, PyObject* args) {
@@ -62,11 +83,16 @@ static PyObject* vc_lift_octlift(PyObject* self, PyObject* args) {
 		return NULL;
 	}
 
-	Graph* graph = ((PyGraph*) g)->g;
+	Graph* graph = get_graph(g);
 	Set* octset = ((PySet*) o)->s;
 	Set* partial = ((PySet*) p)->s;
 
-	return make_PySet(oct_lift(graph, octset, partial), false);
+	Set* cover;
+	{
+		WithoutGIL nogil({g, o, p});
+		cover = oct_lift(graph, octset, partial);
+	}
+	return make_PySet(cover, false);
 }
 
 static PyObject* vc_lift_biplift(PyObject* self, PyObject* args) {
@@ -78,11 +104,16 @@ static PyObject* vc_lift_biplift(PyObject* self, PyObject* args) {
 		return NULL;
 	}
 
-	Graph* graph = ((PyGraph*) g)->g;
+	Graph* graph = get_graph(g);
 	Set* octset = ((PySet*) o)->s;
 	Set* partial = ((PySet*) p)->s;
 
-	return make_PySet(bip_lift(graph, octset, partial), false);
+	Set* cover;
+	{
+		WithoutGIL nogil({g, o, p});
+		cover = bip_lift(graph, octset, partial);
+	}
+	return make_PySet(cover, false);
 }
 
 static PyObject* vc_lift_recursivelift(PyObject* self, PyObject* args) {
@@ -94,11 +125,16 @@ static PyObject* vc_lift_recursivelift(PyObject* self, PyObject* args) {
 		return NULL;
 	}
 
-	Graph* graph = ((PyGraph*) g)->g;
+	Graph* graph = get_graph(g);
 	Set* octset = ((PySet*) o)->s;
 	Set* partial = ((PySet*) p)->s;
 
-	return make_PySet(recursive_lift(graph, octset, partial), false);
+	Set* cover;
+	{
+		WithoutGIL nogil({g, o, p});
+		cover = recursive_lift(graph, octset, partial);
+	}
+	return make_PySet(cover, false);
 }
 
 static PyObject* vc_lift_recoctlift(PyObject* self, PyObject* args) {
@@ -110,11 +146,16 @@ static PyObject* vc_lift_recoctlift(PyObject* self, PyObject* args) {
 		return NULL;
 	}
 
-	Graph* graph = ((PyGraph*) g)->g;
+	Graph* graph = get_graph(g);
 	Set* octset = ((PySet*) o)->s;
 	Set* partial = ((PySet*) p)->s;
 
-	return make_PySet(recursive_oct_lift(graph, octset, partial), false);
+	Set* cover;
+	{
+		WithoutGIL nogil({g, o, p});
+		cover = recursive_oct_lift(graph, octset, partial);
+	}
+	return make_PySet(cover, false);
 }
 
 static PyObject* vc_lift_recbiplift(PyObject* self, PyObject* args) {
@@ -126,11 +167,180 @@ static PyObject* vc_lift_recbiplift(PyObject* self, PyObject* args) {
 		return NULL;
 	}
 
-	Graph* graph = ((PyGraph*) g)->g;
+	Graph* graph = get_graph(g);
+	Set* octset = ((PySet*) o)->s;
+	Set* partial = ((PySet*) p)->s;
+
+	Set* cover;
+	{
+		WithoutGIL nogil({g, o, p});
+		cover = recursive_bip_lift(graph, octset, partial);
+	}
+	return make_PySet(cover, false);
+}
+
+static PyObject* vc_lift_recursiveklift(PyObject* self, PyObject* args) {
+	PyObject* g;
+	PyObject* o;
+	PyObject* p;
+	int depth;
+	int threshold = RECURSIVE_THRESHOLD;
+
+	if (!PyArg_ParseTuple(args, "OOOi|i", &g, &o, &p, &depth, &threshold)) {
+		return NULL;
+	}
+
+	Set* octset = ((PySet*) o)->s;
+	Set* partial = ((PySet*) p)->s;
+
+	CSRGraph* csr = get_csr(g);
+	Graph* graph = csr == NULL ? get_graph(g) : NULL;
+	Set* cover;
+	{
+		WithoutGIL nogil({g, o, p});
+		cover = csr != NULL ? recursive_k_lift(csr, octset, partial, depth, threshold) : recursive_k_lift(graph, octset, partial, depth, threshold);
+	}
+	return make_PySet(cover, false);
+}
+
+static PyObject* vc_lift_recoctklift(PyObject* self, PyObject* args) {
+	PyObject* g;
+	PyObject* o;
+	PyObject* p;
+	int depth;
+	int threshold = RECURSIVE_THRESHOLD;
+
+	if (!PyArg_ParseTuple(args, "OOOi|i", &g, &o, &p, &depth, &threshold)) {
+		return NULL;
+	}
+
 	Set* octset = ((PySet*) o)->s;
 	Set* partial = ((PySet*) p)->s;
 
-	return make_PySet(recursive_bip_lift(graph, octset, partial), false);
+	CSRGraph* csr = get_csr(g);
+	Graph* graph = csr == NULL ? get_graph(g) : NULL;
+	Set* cover;
+	{
+		WithoutGIL nogil({g, o, p});
+		cover = csr != NULL ? recursive_oct_k_lift(csr, octset, partial, depth, threshold) : recursive_oct_k_lift(graph, octset, partial, depth, threshold);
+	}
+	return make_PySet(cover, false);
+}
+
+static PyObject* vc_lift_recursivecover(PyObject* self, PyObject* args) {
+	PyObject* g;
+	int depth;
+	int threshold = RECURSIVE_THRESHOLD;
+
+	if (!PyArg_ParseTuple(args, "Oi|i", &g, &depth, &threshold)) {
+		return NULL;
+	}
+
+	CSRGraph* csr = get_csr(g);
+	Graph* graph = csr == NULL ? get_graph(g) : NULL;
+	Set* cover;
+	{
+		WithoutGIL nogil({g});
+		cover = csr != NULL ? recursive_cover(csr, depth, threshold) : recursive_cover(graph, depth, threshold);
+	}
+	return make_PySet(cover, false);
+}
+
+static PyObject* vc_lift_liftall(PyObject* self, PyObject* args) {
+	PyObject* g;
+	PyObject* o;
+	PyObject* p;
+	PyObject* n = NULL;
+
+	if (!PyArg_ParseTuple(args, "OOO|O", &g, &o, &p, &n)) {
+		return NULL;
+	}
+
+	Graph* graph = get_graph(g);
+	Set* octset = ((PySet*) o)->s;
+	Set* partial = ((PySet*) p)->s;
+
+	std::vector<std::string> names;
+	if (n == NULL || n == Py_None) {
+		names.assign(lift_names, lift_names + NUM_LIFTS);
+	}
+	else {
+		PyObject* seq = PySequence_Fast(n, "names must be a sequence of strings");
+		if (seq == NULL) {
+			return NULL;
+		}
+
+		for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(seq); i++) {
+			const char* name = PyUnicode_AsUTF8(PySequence_Fast_GET_ITEM(seq, i));
+			if (name == NULL) {
+				Py_DECREF(seq);
+				return NULL;
+			}
+			names.push_back(name);
+		}
+		Py_DECREF(seq);
+	}
+
+	for (auto it = names.begin(); it != names.end(); ++it) {
+		if (std::find(lift_names, lift_names + NUM_LIFTS, *it) == lift_names + NUM_LIFTS) {
+			PyErr_Format(PyExc_ValueError, "unknown lift '%s'", it->c_str());
+			return NULL;
+		}
+	}
+
+	std::vector<LiftResult> results;
+	{
+		WithoutGIL nogil({g, o, p});
+		LiftEngine engine(graph, octset, partial);
+		results = engine.run(names);
+	}
+
+	// a missing cover, for example from a cancelled job, raises, and the
+	// covers after it are freed
+	PyObject* ret = PyDict_New();
+	for (auto it = results.begin(); it != results.end(); ++it) {
+		if (ret == NULL) {
+			delete it->cover;
+			continue;
+		}
+
+		PyObject* value = Py_BuildValue("Nd", make_PySet(it->cover, false), it->time);
+		if (value == NULL || PyDict_SetItemString(ret, it->name.c_str(), value) < 0) {
+			Py_XDECREF(value);
+			Py_CLEAR(ret);
+			continue;
+		}
+		Py_DECREF(value);
+	}
+
+	return ret;
+}
+
+static PyObject* vc_lift_portfolio(PyObject* self, PyObject* args) {
+	PyObject* g;
+	PyObject* o;
+	PyObject* p;
+	double seconds;
+	int lowerbound = 0;
+
+	if (!PyArg_ParseTuple(args, "OOOd|i", &g, &o, &p, &seconds, &lowerbound)) {
+		return NULL;
+	}
+
+	Graph* graph = get_graph(g);
+	Set* octset = ((PySet*) o)->s;
+	Set* partial = ((PySet*) p)->s;
+
+	PortfolioResult result;
+	{
+		WithoutGIL nogil({g, o, p});
+		result = portfolio_lift(graph, octset, partial, seconds, lowerbound);
+	}
+	if (result.cover == NULL) {
+		return Py_BuildValue("OOdO", Py_None, Py_None, result.time, Py_False);
+	}
+
+	return Py_BuildValue("NsdO", make_PySet(result.cover, false), result.strategy.c_str(), result.time, result.bound_met ? Py_True : Py_False);
 }
 
 static PyMethodDef vc_lift_methods[] = {
@@ -142,6 +352,11 @@ static PyMethodDef vc_lift_methods[] = {
 	{"recursive_lift", vc_lift_recursivelift, METH_VARARGS, "computes a complete vertex cover from a partial solution and an octset"},
 	{"recursive_oct_lift", vc_lift_recoctlift, METH_VARARGS, "computes a complete vertex cover from a partial solution and an octset"},
 	{"recursive_bip_lift", vc_lift_recbiplift, METH_VARARGS, "computes a complete vertex cover from a partial solution and an octset"},
+	{"recursive_k_lift", vc_lift_recursiveklift, METH_VARARGS, "computes a complete vertex cover, peeling octsets to the given depth"},
+	{"recursive_oct_k_lift", vc_lift_recoctklift, METH_VARARGS, "computes a complete vertex cover, peeling octsets of the octset to the given depth"},
+	{"recursive_cover", vc_lift_recursivecover, METH_VARARGS, "computes a vertex cover by structural rounding, peeling octsets to the given depth"},
+	{"portfolio_lift", vc_lift_portfolio, METH_VARARGS, "runs all lifts concurrently until a deadline or lower bound, returning the best cover, its lift and time"},
+	{"lift_all", vc_lift_liftall, METH_VARARGS, "runs several lifts sharing their intermediate subgraphs, returning each cover and time"},
 	{NULL},
 };
 
@@ -0,0 +1,639 @@
+
+#include "vc_recursive.hpp"
+#include "bipartite.hpp"
+#include "cancel.hpp"
+#include "csr.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#define INF 1000000000
+// components at least this large are recursed on by separate threads
+#define PARALLEL_BRANCH 1024
+
+#define AVAIL 1
+#define ACTIVE 2
+#define VISITED 4
+
+// per thread buffers, handed out from a pool so that deep recursion reuses them
+struct Scratch {
+	std::vector<int> head;
+	std::vector<int> queue;
+	std::vector<int> stack;
+};
+
+// the per vertex arrays are allocated once for the whole graph. the vertices
+// of the set being processed share a tag, so disjoint branches can use the same
+// arrays concurrently: branches are components, so no edge joins two of them.
+// a branch still reads the tags of neighbors outside its set while another
+// branch retags them, so the tags are relaxed atomics
+struct Recursion {
+	CSRGraph* graph;
+	int threshold;
+	std::atomic<int> ids;
+	std::atomic<bool> failed;
+
+	std::atomic<int>* tag;
+	int* deg;
+	int* next;
+	int* prev;
+	int* mate;
+	int* dist;
+	long* pos;
+	char* state;
+	signed char* color;
+	char* incover;
+
+	std::mutex lock;
+	std::vector<Scratch*> pool;
+
+	Recursion(CSRGraph* g, int t) : graph(g), threshold(t), ids(0), failed(false) {
+		int n = g->n;
+		tag = new std::atomic<int>[n];
+		deg = new int[n];
+		next = new int[n];
+		prev = new int[n];
+		mate = new int[n];
+		dist = new int[n];
+		pos = new long[n];
+		state = new char[n];
+		color = new signed char[n];
+		incover = new char[n];
+
+		for (int u = 0; u < n; u++) {
+			tag[u].store(0, std::memory_order_relaxed);
+			state[u] = 0;
+			incover[u] = 0;
+		}
+	}
+
+	~Recursion() {
+		delete[] tag;
+		delete[] deg;
+		delete[] next;
+		delete[] prev;
+		delete[] mate;
+		delete[] dist;
+		delete[] pos;
+		delete[] state;
+		delete[] color;
+		delete[] incover;
+
+		for (auto it = pool.begin(); it != pool.end(); ++it) {
+			delete *it;
+		}
+	}
+
+	Scratch* acquire() {
+		std::lock_guard<std::mutex> guard(lock);
+		if (pool.empty()) {
+			return new Scratch();
+		}
+
+		Scratch* s = pool.back();
+		pool.pop_back();
+		return s;
+	}
+
+	void release(Scratch* s) {
+		std::lock_guard<std::mutex> guard(lock);
+		pool.push_back(s);
+	}
+
+	bool tagged(int u, int id) {
+		return tag[u].load(std::memory_order_relaxed) == id;
+	}
+
+	void settag(int u, int id) {
+		tag[u].store(id, std::memory_order_relaxed);
+	}
+
+	int retag(std::vector<int>& verts) {
+		int id = ++ids;
+		for (auto it = verts.begin(); it != verts.end(); ++it) {
+			settag(*it, id);
+		}
+		return id;
+	}
+
+	void link(Scratch* s, int u) {
+		int d = deg[u];
+		prev[u] = -1;
+		next[u] = s->head[d];
+		if (s->head[d] != -1) {
+			prev[s->head[d]] = u;
+		}
+		s->head[d] = u;
+	}
+
+	void unlink(Scratch* s, int u) {
+		if (prev[u] != -1) {
+			next[prev[u]] = next[u];
+		}
+		else {
+			s->head[deg[u]] = next[u];
+		}
+
+		if (next[u] != -1) {
+			prev[next[u]] = prev[u];
+		}
+	}
+
+	// same minimum degree peeling as remove_indset, restricted to the available
+	// vertices of the tagged set. removed vertices get color c
+	bool remove_indset(std::vector<int>& verts, int id, Scratch* s, std::vector<int>& out, signed char c) {
+		int maxdeg = 0;
+		int count = 0;
+		for (auto it = verts.begin(); it != verts.end(); ++it) {
+			int u = *it;
+			if (!(state[u] & AVAIL)) {
+				continue;
+			}
+
+			int degree = 0;
+			for (int* iv = graph->begin(u); iv != graph->end(u); ++iv) {
+				degree += tagged(*iv, id) && (state[*iv] & AVAIL);
+			}
+			deg[u] = degree;
+			maxdeg = degree > maxdeg ? degree : maxdeg;
+		}
+
+		s->head.assign(maxdeg + 1, -1);
+		int mindeg = maxdeg;
+		for (auto it = verts.begin(); it != verts.end(); ++it) {
+			int u = *it;
+			if (state[u] & AVAIL) {
+				state[u] |= ACTIVE;
+				link(s, u);
+				mindeg = deg[u] < mindeg ? deg[u] : mindeg;
+				++count;
+			}
+		}
+
+		int steps = 0;
+		while (count > 0) {
+			if ((++steps & 1023) == 0 && cancelled()) {
+				return false;
+			}
+
+			while (s->head[mindeg] == -1) {
+				++mindeg;
+			}
+
+			int u = s->head[mindeg];
+			unlink(s, u);
+			state[u] = 0;
+			color[u] = c;
+			out.push_back(u);
+			--count;
+
+			for (int* iv = graph->begin(u); iv != graph->end(u); ++iv) {
+				int v = *iv;
+				if (!tagged(v, id) || !(state[v] & ACTIVE)) {
+					continue;
+				}
+
+				unlink(s, v);
+				state[v] &= ~ACTIVE;
+				--count;
+
+				for (int* iw = graph->begin(v); iw != graph->end(v); ++iw) {
+					int w = *iw;
+					if (!tagged(w, id) || !(state[w] & ACTIVE)) {
+						continue;
+					}
+
+					unlink(s, w);
+					deg[w] -= 1;
+					link(s, w);
+					mindeg = deg[w] < mindeg ? deg[w] : mindeg;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	// splits the tagged set into two independent sets and the octset left over
+	bool peel(std::vector<int>& verts, int id, Scratch* s, std::vector<int>& left,
+			  std::vector<int>& right, std::vector<int>& octset) {
+		for (auto it = verts.begin(); it != verts.end(); ++it) {
+			state[*it] = AVAIL;
+			color[*it] = COLOR_OCT;
+		}
+
+		if (!remove_indset(verts, id, s, left, COLOR_LEFT) || !remove_indset(verts, id, s, right, COLOR_RIGHT)) {
+			return false;
+		}
+
+		for (auto it = verts.begin(); it != verts.end(); ++it) {
+			if (state[*it] & AVAIL) {
+				octset.push_back(*it);
+				state[*it] = 0;
+			}
+		}
+
+		return true;
+	}
+
+	// finds an augmenting path from the free vertex r along the bfs layers
+	bool augment(int r, int id, Scratch* s) {
+		std::vector<int>& stack = s->stack;
+		stack.clear();
+		stack.push_back(r);
+
+		while (!stack.empty()) {
+			int u = stack.back();
+			if (pos[u] == graph->offsets[u + 1]) {
+				dist[u] = INF;
+				stack.pop_back();
+				continue;
+			}
+
+			int v = graph->nbrs[pos[u]++];
+			if (!tagged(v, id) || color[v] != COLOR_RIGHT) {
+				continue;
+			}
+
+			int w = mate[v];
+			if (w == -1) {
+				for (auto it = stack.begin(); it != stack.end(); ++it) {
+					int x = *it;
+					int y = graph->nbrs[pos[x] - 1];
+					mate[x] = y;
+					mate[y] = x;
+				}
+				return true;
+			}
+
+			if (dist[w] == dist[u] + 1) {
+				stack.push_back(w);
+			}
+		}
+
+		return false;
+	}
+
+	// hopcroft-karp between the tagged left and right vertices (edges inside a
+	// side are ignored), then marks a minimum vertex cover by konig's theorem
+	bool match_cover(std::vector<int>& left, std::vector<int>& right, int id, Scratch* s) {
+		for (auto it = left.begin(); it != left.end(); ++it) {
+			mate[*it] = -1;
+		}
+		for (auto it = right.begin(); it != right.end(); ++it) {
+			mate[*it] = -1;
+		}
+
+		std::vector<int>& queue = s->queue;
+		while (true) {
+			if (cancelled()) {
+				return false;
+			}
+
+			queue.clear();
+			for (auto it = left.begin(); it != left.end(); ++it) {
+				if (mate[*it] == -1) {
+					dist[*it] = 0;
+					queue.push_back(*it);
+				}
+				else {
+					dist[*it] = INF;
+				}
+			}
+
+			bool found = false;
+			for (size_t h = 0; h < queue.size(); h++) {
+				int u = queue[h];
+				for (int* iv = graph->begin(u); iv != graph->end(u); ++iv) {
+					int v = *iv;
+					if (!tagged(v, id) || color[v] != COLOR_RIGHT) {
+						continue;
+					}
+
+					int w = mate[v];
+					if (w == -1) {
+						found = true;
+					}
+					else if (dist[w] == INF) {
+						dist[w] = dist[u] + 1;
+						queue.push_back(w);
+					}
+				}
+			}
+
+			if (!found) {
+				break;
+			}
+
+			for (auto it = left.begin(); it != left.end(); ++it) {
+				pos[*it] = graph->offsets[*it];
+			}
+			for (auto it = left.begin(); it != left.end(); ++it) {
+				if (mate[*it] == -1) {
+					augment(*it, id, s);
+				}
+			}
+		}
+
+		// vertices reachable from free left vertices by alternating paths
+		queue.clear();
+		for (auto it = left.begin(); it != left.end(); ++it) {
+			state[*it] = 0;
+			if (mate[*it] == -1) {
+				state[*it] = VISITED;
+				queue.push_back(*it);
+			}
+		}
+		for (auto it = right.begin(); it != right.end(); ++it) {
+			state[*it] = 0;
+		}
+
+		for (size_t h = 0; h < queue.size(); h++) {
+			int u = queue[h];
+			for (int* iv = graph->begin(u); iv != graph->end(u); ++iv) {
+				int v = *iv;
+				if (!tagged(v, id) || color[v] != COLOR_RIGHT || state[v]) {
+					continue;
+				}
+
+				state[v] = VISITED;
+				int w = mate[v];
+				if (w != -1 && !state[w]) {
+					state[w] = VISITED;
+					queue.push_back(w);
+				}
+			}
+		}
+
+		for (auto it = left.begin(); it != left.end(); ++it) {
+			if (!state[*it]) {
+				incover[*it] = 1;
+			}
+			state[*it] = 0;
+		}
+		for (auto it = right.begin(); it != right.end(); ++it) {
+			if (state[*it]) {
+				incover[*it] = 1;
+			}
+			state[*it] = 0;
+		}
+
+		return true;
+	}
+
+	// one level: peel an octset, cover the bipartite part exactly and recurse on
+	// the octset together with the uncovered bipartite vertices
+	void solve(std::vector<int>& verts, int depth, bool nested) {
+		if (failed) {
+			return;
+		}
+
+		std::vector<int> residual;
+		{
+			Scratch* s = acquire();
+			std::vector<int> left, right, octset;
+			int id = retag(verts);
+			bool done = peel(verts, id, s, left, right, octset) && match_cover(left, right, id, s);
+			release(s);
+
+			if (!done) {
+				failed = true;
+				return;
+			}
+
+			if (depth <= 1 || (int) verts.size() <= threshold) {
+				for (auto it = octset.begin(); it != octset.end(); ++it) {
+					incover[*it] = 1;
+				}
+				return;
+			}
+
+			residual.swap(octset);
+			for (auto it = left.begin(); it != left.end(); ++it) {
+				if (!incover[*it]) {
+					residual.push_back(*it);
+				}
+			}
+			for (auto it = right.begin(); it != right.end(); ++it) {
+				if (!incover[*it]) {
+					residual.push_back(*it);
+				}
+			}
+
+			// the bipartite part was entirely left uncovered, recursing would
+			// only repeat this level
+			if (residual.size() == verts.size()) {
+				for (auto it = verts.begin(); it != verts.end(); ++it) {
+					if (color[*it] == COLOR_OCT) {
+						incover[*it] = 1;
+					}
+				}
+				return;
+			}
+		}
+
+		split(residual, depth - 1, nested);
+	}
+
+	// solves each component of the set with at least one edge, in parallel when
+	// several of them are large
+	void split(std::vector<int>& verts, int depth, bool nested) {
+		std::vector<std::vector<int> > components;
+		{
+			Scratch* s = acquire();
+			int id = retag(verts);
+			int seen = ++ids;
+			for (auto it = verts.begin(); it != verts.end(); ++it) {
+				if (!tagged(*it, id)) {
+					continue;
+				}
+
+				std::vector<int>& queue = s->queue;
+				queue.clear();
+				queue.push_back(*it);
+				settag(*it, seen);
+				for (size_t h = 0; h < queue.size(); h++) {
+					int u = queue[h];
+					for (int* iv = graph->begin(u); iv != graph->end(u); ++iv) {
+						if (tagged(*iv, id)) {
+							settag(*iv, seen);
+							queue.push_back(*iv);
+						}
+					}
+				}
+
+				if (queue.size() == 2) {
+					incover[queue[0]] = 1;
+				}
+				else if (queue.size() > 2) {
+					components.push_back(queue);
+				}
+			}
+			release(s);
+		}
+
+		std::sort(components.begin(), components.end(), [](const std::vector<int>& a, const std::vector<int>& b) {
+			return a.size() > b.size();
+		});
+
+		int large = 0;
+		for (auto it = components.begin(); it != components.end(); ++it) {
+			large += it->size() >= PARALLEL_BRANCH;
+		}
+
+		if (!nested && large > 1) {
+			parallel_for(components.size(), [&](int i) {
+				solve(components[i], depth, true);
+			});
+		}
+		else {
+			for (auto it = components.begin(); it != components.end(); ++it) {
+				solve(*it, depth, nested);
+			}
+		}
+	}
+};
+
+// structural rounding to any depth: each level removes an octset by
+// vertex_delete's peeling, covers the bipartite rest exactly and recurses on
+// the octset plus the bipartite vertices left uncovered, until depth levels are
+// used or the set has at most threshold vertices
+Set* recursive_cover(Graph* graph, int depth, int threshold) {
+	CSRGraph csr(graph);
+	return recursive_cover(&csr, depth, threshold);
+}
+
+Set* recursive_cover(CSRGraph* csr, int depth, int threshold) {
+	Recursion r(csr, threshold);
+
+	std::vector<int> verts;
+	for (int u = 0; u < csr->n; u++) {
+		verts.push_back(u);
+	}
+	r.split(verts, depth < 1 ? 1 : depth, false);
+
+	if (r.failed) {
+		return NULL;
+	}
+
+	Set* cover = new Set();
+	for (int u = 0; u < csr->n; u++) {
+		if (r.incover[u]) {
+			cover->insert(csr->labels[u]);
+		}
+	}
+
+	return cover;
+}
+
+// generalizes recursive_lift: depth 1 is naive_lift, depth 2 recursive_lift
+Set* recursive_k_lift(Graph* graph, Set* octset, Set* partial, int depth, int threshold) {
+	CSRGraph csr(graph);
+	return recursive_k_lift(&csr, octset, partial, depth, threshold);
+}
+
+Set* recursive_k_lift(CSRGraph* csr, Set* octset, Set* partial, int depth, int threshold) {
+	Recursion r(csr, threshold);
+
+	std::vector<int> verts;
+	for (int u = 0; u < csr->n; u++) {
+		int label = csr->labels[u];
+		if (octset->contains(label) || !partial->contains(label)) {
+			if (depth <= 1 && octset->contains(label)) {
+				r.incover[u] = 1;
+			}
+			verts.push_back(u);
+		}
+	}
+
+	if (depth > 1) {
+		r.split(verts, depth - 1, false);
+		if (r.failed) {
+			return NULL;
+		}
+	}
+
+	Set* cover = new Set();
+	for (int u = 0; u < csr->n; u++) {
+		if (r.incover[u]) {
+			cover->insert(csr->labels[u]);
+		}
+	}
+
+	for (Set::Iterator it = partial->begin(); it != partial->end(); ++it) {
+		cover->insert(*it);
+	}
+
+	return cover;
+}
+
+// generalizes recursive_oct_lift: covers the octset to the given depth, then
+// the remaining bipartite graph exactly
+Set* recursive_oct_k_lift(Graph* graph, Set* octset, Set* partial, int depth, int threshold) {
+	CSRGraph csr(graph);
+	return recursive_oct_k_lift(&csr, octset, partial, depth, threshold);
+}
+
+Set* recursive_oct_k_lift(CSRGraph* csr, Set* octset, Set* partial, int depth, int threshold) {
+	Recursion r(csr, threshold);
+
+	std::vector<int> verts;
+	for (int u = 0; u < csr->n; u++) {
+		if (octset->contains(csr->labels[u])) {
+			if (depth <= 1) {
+				r.incover[u] = 1;
+			}
+			verts.push_back(u);
+		}
+	}
+
+	if (depth > 1) {
+		r.split(verts, depth - 1, false);
+		if (r.failed) {
+			return NULL;
+		}
+	}
+
+	// the uncovered octset vertices are independent, and so are the vertices
+	// outside the octset and the partial cover
+	std::vector<int> left, right;
+	for (int u = 0; u < csr->n; u++) {
+		if (r.incover[u] || partial->contains(csr->labels[u])) {
+			continue;
+		}
+
+		if (octset->contains(csr->labels[u])) {
+			r.color[u] = COLOR_LEFT;
+			left.push_back(u);
+		}
+		else {
+			r.color[u] = COLOR_RIGHT;
+			right.push_back(u);
+		}
+	}
+
+	std::vector<int> rest(left);
+	rest.insert(rest.end(), right.begin(), right.end());
+	Scratch* s = r.acquire();
+	bool done = r.match_cover(left, right, r.retag(rest), s);
+	r.release(s);
+	if (!done) {
+		return NULL;
+	}
+
+	Set* cover = new Set();
+	for (int u = 0; u < csr->n; u++) {
+		if (r.incover[u]) {
+			cover->insert(csr->labels[u]);
+		}
+	}
+
+	for (Set::Iterator it = partial->begin(); it != partial->end(); ++it) {
+		cover->insert(*it);
+	}
+
+	return cover;
+}
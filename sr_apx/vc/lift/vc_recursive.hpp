@@ -0,0 +1,21 @@
+
+#ifndef VC_RECURSIVE_H
+#define VC_RECURSIVE_H
+
+#include "graph.hpp"
+#include "csr.hpp"
+#include "setmap.hpp"
+
+// sets with at most this many vertices are not split any further
+#define RECURSIVE_THRESHOLD 64
+
+Set* recursive_cover(Graph*, int, int threshold = RECURSIVE_THRESHOLD);
+Set* recursive_k_lift(Graph*, Set*, Set*, int, int threshold = RECURSIVE_THRESHOLD);
+Set* recursive_oct_k_lift(Graph*, Set*, Set*, int, int threshold = RECURSIVE_THRESHOLD);
+
+// the same on a csr snapshot, which may be mapped from a file
+Set* recursive_cover(CSRGraph*, int, int threshold = RECURSIVE_THRESHOLD);
+Set* recursive_k_lift(CSRGraph*, Set*, Set*, int, int threshold = RECURSIVE_THRESHOLD);
+Set* recursive_oct_k_lift(CSRGraph*, Set*, Set*, int, int threshold = RECURSIVE_THRESHOLD);
+
+#endif
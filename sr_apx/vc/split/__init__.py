@@ -0,0 +1,2 @@
+
+from .lib_vc_split import split_std_apx, split_heuristic_apx, split_bip_exact
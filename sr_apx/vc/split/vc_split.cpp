@@ -0,0 +1,112 @@
+
+#include "vc_split.hpp"
+#include "vc_apx.hpp"
+#include "vc_exact.hpp"
+#include "components.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <vector>
+
+bool larger_component(Set* a, Set* b) {
+	return a->size() > b->size();
+}
+
+Set* split_solve(Graph* graph, Set* (*solver)(Graph*), int small, int threads) {
+	if (small > SMALL_EXACT_MAX) {
+		small = SMALL_EXACT_MAX;
+	}
+
+	std::vector<Set*> components = connected_components(graph);
+
+	// isolated vertices need no cover and single edges need one endpoint
+	Set* cover = new Set();
+	std::vector<Set*> pending;
+	for (auto it = components.begin(); it != components.end(); ++it) {
+		Set* component = *it;
+		if (component->size() == 2) {
+			cover->insert(*(component->begin()));
+		}
+
+		if (component->size() > 2) {
+			pending.push_back(component);
+		}
+		else {
+			delete component;
+		}
+	}
+
+	// a single large component is solved without copying it, unless there
+	// are single edges, which the solver would cover a second time
+	if (pending.size() == 1 && pending[0]->size() > small) {
+		Graph* h = cover->size() == 0 ? graph : graph->subgraph(pending[0]);
+		delete pending[0];
+		Set* subcover = h == NULL ? NULL : solver(h);
+		if (h != graph) {
+			delete h;
+		}
+		if (subcover == NULL) {
+			delete cover;
+			return NULL;
+		}
+
+		for (Set::Iterator it = cover->begin(); it != cover->end(); ++it) {
+			subcover->insert(*it);
+		}
+		delete cover;
+		return subcover;
+	}
+
+	// largest components first so they are not left for the end of the pool
+	std::sort(pending.begin(), pending.end(), larger_component);
+
+	int count = pending.size();
+	std::vector<Set*> subcovers(count, NULL);
+	parallel_for(count, [&](int i) {
+		Graph* h = graph->subgraph(pending[i]);
+		if (h == NULL) {
+			return;
+		}
+
+		if (pending[i]->size() <= small) {
+			subcovers[i] = small_exact(h);
+		}
+		else {
+			subcovers[i] = solver(h);
+		}
+		delete h;
+	}, threads);
+
+	bool failed = false;
+	for (int i = 0; i < count; i++) {
+		delete pending[i];
+		if (subcovers[i] == NULL) {
+			failed = true;
+			continue;
+		}
+
+		for (Set::Iterator it = subcovers[i]->begin(); it != subcovers[i]->end(); ++it) {
+			cover->insert(*it);
+		}
+		delete subcovers[i];
+	}
+
+	if (failed) {
+		delete cover;
+		return NULL;
+	}
+
+	return cover;
+}
+
+Set* split_std_apx(Graph* graph) {
+	return split_solve(graph, std_apx);
+}
+
+Set* split_heuristic_apx(Graph* graph) {
+	return split_solve(graph, heuristic_apx);
+}
+
+Set* split_bip_exact(Graph* graph) {
+	return split_solve(graph, bip_exact);
+}
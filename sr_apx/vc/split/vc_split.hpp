@@ -0,0 +1,16 @@
+
+#ifndef VC_SPLIT_H
+#define VC_SPLIT_H
+
+#include "graph.hpp"
+#include "setmap.hpp"
+
+// components with at most this many vertices are solved with small_exact
+#define SPLIT_SMALL 32
+
+Set* split_solve(Graph*, Set* (*)(Graph*), int small = SPLIT_SMALL, int threads = 0);
+Set* split_std_apx(Graph*);
+Set* split_heuristic_apx(Graph*);
+Set* split_bip_exact(Graph*);
+
+#endif
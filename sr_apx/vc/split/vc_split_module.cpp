@@ -0,0 +1,62 @@
+
+#include <Python.h>
+
+#include "vc_split.hpp"
+#include "vc_apx.hpp"
+#include "vc_exact.hpp"
+#include "pygraph.hpp"
+#include "pyset.hpp"
+#include "pycall.hpp"
+
+static PyObject* split_run(PyObject* args, Set* (*solver)(Graph*)) {
+	PyObject* g;
+	int small = SPLIT_SMALL;
+	int threads = 0;
+	if (!PyArg_ParseTuple(args, "O|ii", &g, &small, &threads)) {
+		return NULL;
+	}
+
+	Graph* graph = get_graph(g);
+	Set* cover;
+	{
+		WithoutGIL nogil({g});
+		cover = split_solve(graph, solver, small, threads);
+	}
+	if (cover == NULL) {
+		PyErr_SetString(PyExc_ValueError, "solver failed on a component");
+		return NULL;
+	}
+
+	return make_PySet(cover, false);
+}
+
+static PyObject* vc_split_stdapx(PyObject* self, PyObject* args) {
+	return split_run(args, std_apx);
+}
+
+static PyObject* vc_split_heuristic(PyObject* self, PyObject* args) {
+	return split_run(args, heuristic_apx);
+}
+
+static PyObject* vc_split_bipexact(PyObject* self, PyObject* args) {
+	return split_run(args, bip_exact);
+}
+
+static PyMethodDef vc_split_methods[] = {
+	{"split_std_apx", vc_split_stdapx, METH_VARARGS, "runs std_apx on each connected component in parallel, solving small components exactly"},
+	{"split_heuristic_apx", vc_split_heuristic, METH_VARARGS, "runs heuristic_apx on each connected component in parallel, solving small components exactly"},
+	{"split_bip_exact", vc_split_bipexact, METH_VARARGS, "runs bip_exact on each connected component of a bipartite graph in parallel"},
+	{NULL},
+};
+
+static struct PyModuleDef vc_split_module = {
+	PyModuleDef_HEAD_INIT,
+	"vc_split",
+	"Python interface for component-wise vertex cover algorithms",
+	-1,
+	vc_split_methods
+};
+
+PyMODINIT_FUNC PyInit_lib_vc_split() {
+	return PyModule_Create(&vc_split_module);
+}
@@ -0,0 +1,2 @@
+
+from .lib_vc_stream import stream_cover
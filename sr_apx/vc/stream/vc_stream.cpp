@@ -0,0 +1,178 @@
+
+#include <vector>
+
+#include "vc_stream.hpp"
+#include "graph.hpp"
+
+// union find over the vertices that also tracks the parity of the path from
+// each vertex to its root, so that edges can be checked against a 2-coloring.
+// named apart from the ParityForest of oct_exact, which lives in the same
+// library
+struct StreamForest {
+	std::vector<int> parent;
+	std::vector<char> parity;
+
+	StreamForest(int n) : parent(n), parity(n, 0) {
+		for (int u = 0; u < n; u++) {
+			parent[u] = u;
+		}
+	}
+
+	// returns the root of u and sets p to the parity of u relative to it
+	int find(int u, int& p) {
+		int r = u;
+		p = 0;
+		while (parent[r] != r) {
+			p ^= parity[r];
+			r = parent[r];
+		}
+
+		// point the path at the root, keeping the parities consistent
+		int q = p;
+		while (parent[u] != r && u != r) {
+			int next = parent[u];
+			int nq = q ^ parity[u];
+			parent[u] = r;
+			parity[u] = q;
+			u = next;
+			q = nq;
+		}
+		return r;
+	}
+};
+
+StreamCover stream_cover(const char* filename) {
+	StreamCover result;
+	result.n = 0;
+	result.m = 0;
+	result.passes = 0;
+	result.matching = 0;
+	result.octset = NULL;
+	result.cover = NULL;
+
+	// pass 1: degrees and a maximal matching, growing the arrays as labels
+	// appear so the vertex count need not be known in advance
+	std::vector<int> degree;
+	std::vector<int> mate;
+	int n = stream_graph(filename, [&](int u, int v) {
+		int top = (u > v ? u : v) + 1;
+		if ((int) degree.size() < top) {
+			degree.resize(top, 0);
+			mate.resize(top, -1);
+		}
+
+		++degree[u];
+		++degree[v];
+		++result.m;
+		if (u != v && mate[u] == -1 && mate[v] == -1) {
+			mate[u] = v;
+			mate[v] = u;
+			++result.matching;
+		}
+	});
+	if (n < 0) {
+		return result;
+	}
+	degree.resize(n, 0);
+	mate.resize(n, -1);
+
+	// pass 2: an octset from the edges that close an odd cycle with the edges
+	// accepted so far, taking the endpoint of higher degree
+	StreamForest forest(n);
+	std::vector<char> oct(n, 0);
+	stream_graph(filename, [&](int u, int v) {
+		if (u == v || oct[u] || oct[v]) {
+			return;
+		}
+
+		int pu, pv;
+		int ru = forest.find(u, pu);
+		int rv = forest.find(v, pv);
+		if (ru != rv) {
+			forest.parent[ru] = rv;
+			forest.parity[ru] = pu ^ pv ^ 1;
+		}
+		else if (pu == pv) {
+			oct[degree[u] >= degree[v] ? u : v] = 1;
+		}
+	});
+
+	// pass 3: the vertices with an edge in the bipartite part. each component
+	// of the forest is covered by the smaller of its color classes or its
+	// matched vertices, counting only those vertices
+	std::vector<char> active(n, 0);
+	stream_graph(filename, [&](int u, int v) {
+		if (u != v && !oct[u] && !oct[v]) {
+			active[u] = 1;
+			active[v] = 1;
+		}
+	});
+
+	std::vector<int> root(n);
+	std::vector<char> color(n);
+	std::vector<int> count0(n, 0);
+	std::vector<int> count1(n, 0);
+	std::vector<int> countmatched(n, 0);
+	for (int u = 0; u < n; u++) {
+		int p;
+		root[u] = forest.find(u, p);
+		color[u] = p;
+		if (active[u]) {
+			++(p ? count1 : count0)[root[u]];
+			if (mate[u] != -1) {
+				++countmatched[root[u]];
+			}
+		}
+	}
+
+	std::vector<char> incover(n, 0);
+	for (int u = 0; u < n; u++) {
+		if (!active[u]) {
+			continue;
+		}
+
+		int r = root[u];
+		if (countmatched[r] < count0[r] && countmatched[r] < count1[r]) {
+			incover[u] = mate[u] != -1;
+		}
+		else {
+			incover[u] = color[u] == (count0[r] <= count1[r] ? 0 : 1);
+		}
+	}
+
+	// pass 4: greedy lift, covering each edge still uncovered by its octset
+	// endpoint (of higher degree if both are)
+	stream_graph(filename, [&](int u, int v) {
+		if (u == v || incover[u] || incover[v]) {
+			return;
+		}
+
+		if (oct[u] != oct[v]) {
+			incover[oct[u] ? u : v] = 1;
+		}
+		else {
+			incover[degree[u] >= degree[v] ? u : v] = 1;
+		}
+	});
+	result.passes = 4;
+
+	int size = 0;
+	for (int u = 0; u < n; u++) {
+		size += incover[u];
+	}
+
+	result.n = n;
+	result.octset = new Set();
+	result.cover = new Set();
+	bool matched = 2 * result.matching < size;
+	for (int u = 0; u < n; u++) {
+		if (oct[u]) {
+			result.octset->insert(u);
+		}
+		if (matched ? mate[u] != -1 : incover[u]) {
+			result.cover->insert(u);
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,23 @@
+
+#ifndef VC_STREAM_H
+#define VC_STREAM_H
+
+#include "setmap.hpp"
+
+// cover found by re-reading a graph file a few times, with memory linear in
+// the number of vertices instead of the number of edges
+struct StreamCover {
+	int n;
+	long m;
+	int passes;
+	int matching;
+	Set* octset;
+	Set* cover;
+};
+
+// reads sparse6 files (.s6) or edge lists. the cover has the vertices of a
+// maximal matching if that is smaller than the lifted one. returns a cover
+// of NULL sets if the file cannot be read
+StreamCover stream_cover(const char*);
+
+#endif
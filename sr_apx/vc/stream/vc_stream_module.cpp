@@ -0,0 +1,41 @@
+#include <Python.h>
+
+#include "vc_stream.hpp"
+#include "pyset.hpp"
+#include "pycall.hpp"
+
+static PyObject* vc_stream_streamcover(PyObject* self, PyObject* args) {
+	const char* filename;
+	if (!PyArg_ParseTuple(args, "s", &filename)) {
+		return NULL;
+	}
+
+	StreamCover result;
+	{
+		WithoutGIL nogil({});
+		result = stream_cover(filename);
+	}
+	if (result.cover == NULL) {
+		PyErr_SetString(PyExc_OSError, "could not read graph file");
+		return NULL;
+	}
+
+	return Py_BuildValue("NNi", make_PySet(result.cover, false), make_PySet(result.octset, false), 2 * result.matching);
+}
+
+static PyMethodDef vc_stream_methods[] = {
+	{"stream_cover", vc_stream_streamcover, METH_VARARGS, "computes a cover, octset and maximal matching size by re-reading a sparse6 or edge list file without loading the graph"},
+	{NULL},
+};
+
+static struct PyModuleDef vc_stream_module = {
+	PyModuleDef_HEAD_INIT,
+	"vc_stream",
+	"Python interface for streaming vertex cover",
+	-1,
+	vc_stream_methods
+};
+
+PyMODINIT_FUNC PyInit_lib_vc_stream() {
+	return PyModule_Create(&vc_stream_module);
+}